@@ -16,8 +16,10 @@ int main(int argc, char **argv) {
     double mass = parameters.get("mass");
     int seed = parameters.get("seed");
     int n_trajectories = parameters.get("n_trajectories");
-    double hmc_steps = parameters.get("hmc_steps");
+    int hmc_steps = parameters.get("hmc_steps");
     double traj_length = parameters.get("traj_length");
+    int tune_trajectories = parameters.get("tune_trajectories");
+    double target_acceptance = parameters.get("target_acceptance");
     std::string configfile = parameters.get("configuration_file");
     int log_level = parameters.get("log_level");
 
@@ -77,6 +79,19 @@ int main(int argc, char **argv) {
         hila::out0 << "No config file " << configfile << ", starting new run\n";
     }
 
+    // Use tuned step counts saved with the configuration if available, otherwise
+    // tune them during the first trajectories.  Only tuned step counts are saved
+    std::string hmcfile = configfile + ".hmc";
+    bool hmc_tuned = false;
+    if (config_found && read_hmc_parameters(hmcfile, integrator_level_2, hmc_steps, traj_length,
+                                            target_acceptance)) {
+        hila::out0 << "Read HMC step parameters from " << hmcfile << "\n";
+        hmc_tuned = true;
+    } else if (tune_trajectories > 0) {
+        hmc_tuned = tune_hmc(integrator_level_2, hmc_steps, traj_length, tune_trajectories,
+                             target_acceptance);
+    }
+
     // Run HMC using the integrator
     for (int step = 0; step < n_trajectories; step++) {
         update_hmc(integrator_level_2, hmc_steps, traj_length);
@@ -84,6 +99,9 @@ int main(int argc, char **argv) {
         hila::out0 << "Plaq: " << plaq << "\n";
 
         gauge.write_file(configfile);
+        if (hmc_tuned)
+            write_hmc_parameters(hmcfile, integrator_level_2, hmc_steps, traj_length,
+                                 target_acceptance);
     }
 
     hila::finishrun();
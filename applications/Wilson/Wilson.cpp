@@ -16,8 +16,10 @@ int main(int argc, char **argv) {
     double hasenbusch_mass = parameters.get("hasenbusch_mass");
     int seed = parameters.get("seed");
     int n_trajectories = parameters.get("n_trajectories");
-    double hmc_steps = parameters.get("hmc_steps");
+    int hmc_steps = parameters.get("hmc_steps");
     double traj_length = parameters.get("traj_length");
+    int tune_trajectories = parameters.get("tune_trajectories");
+    double target_acceptance = parameters.get("target_acceptance");
     std::string configfile = parameters.get("configuration_file");
 
     hila::seed_random(seed);
@@ -57,6 +59,19 @@ int main(int argc, char **argv) {
         gauge.random();
     }
 
+    // Use tuned step counts saved with the configuration if available, otherwise
+    // tune them during the first trajectories.  Only tuned step counts are saved
+    std::string hmcfile = configfile + ".hmc";
+    bool hmc_tuned = false;
+    if (config_found && read_hmc_parameters(hmcfile, integrator_level_3, hmc_steps, traj_length,
+                                            target_acceptance)) {
+        hila::out0 << "Read HMC step parameters from " << hmcfile << "\n";
+        hmc_tuned = true;
+    } else if (tune_trajectories > 0) {
+        hmc_tuned = tune_hmc(integrator_level_3, hmc_steps, traj_length, tune_trajectories,
+                             target_acceptance);
+    }
+
     // Run HMC using the integrator
     for (int step = 0; step < n_trajectories; step++) {
         update_hmc(integrator_level_3, hmc_steps, traj_length);
@@ -64,6 +79,9 @@ int main(int argc, char **argv) {
         hila::out0 << "Plaq: " << plaq << "\n";
 
         gauge.write_file(configfile);
+        if (hmc_tuned)
+            write_hmc_parameters(hmcfile, integrator_level_3, hmc_steps, traj_length,
+                                 target_acceptance);
     }
 
     hila::finishrun();
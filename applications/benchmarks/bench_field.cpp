@@ -266,5 +266,39 @@ int main(int argc, char **argv) {
     timing = timing / 2 / NDIRS / (double)n_runs;
     hila::out0 << "Matrix nearest neighbour communication: " << timing << " ms \n";
 
+    // Time COORDINATE access in a site loop
+    timing = 0;
+    for (n_runs = 1; timing < mintime;) {
+        n_runs *= 2;
+        gettimeofday(&start, NULL);
+
+        for (int i = 0; i < n_runs; i++) {
+            onsites(ALL) {
+                int s = 0;
+                foralldir(d) s += X.coordinate(d);
+                dfield1[X] = s;
+            }
+        }
+        // synchronize();
+        gettimeofday(&end, NULL);
+        timing = timediff(start, end);
+        hila::broadcast(timing);
+    }
+    timing = timing / (double)n_runs;
+    hila::out0 << "Coordinate access: " << timing << " ms \n";
+
+#if defined(EVEN_SITES_FIRST)
+#if defined(COMPACT_COORDINATES)
+    hila::out0 << "Coordinate tables (COMPACT_COORDINATES): "
+               << lattice.mynode.row_coordinates.size() *
+                      (sizeof(CoordinateVector) + sizeof(unsigned char))
+               << " bytes/node, full table would be "
+               << lattice.mynode.sites * sizeof(CoordinateVector) << " bytes\n";
+#else
+    hila::out0 << "Coordinate table: " << lattice.mynode.sites * sizeof(CoordinateVector)
+               << " bytes/node\n";
+#endif
+#endif
+
     hila::finishrun();
 }
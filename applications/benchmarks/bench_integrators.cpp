@@ -0,0 +1,105 @@
+#include "hila.h"
+#include "gauge/staples.h"
+#include "gauge/plaquette_measurements.h"
+#include "hmc/symplectic_integrator.h"
+#include "tools/string_format.h"
+
+// Energy conservation vs. cost of the symplectic integrators in hmc/symplectic_integrator.h,
+// for the real-time evolution of SU(3) gauge fields as in applications/sun_realtime.
+// The same random configuration is evolved over time t_evol with each scheme and step
+// size, and the energy violation max |H(t) - H(0)| / V is compared with the number of
+// force evaluations and the time used.
+
+using group = SU<3, double>;
+
+CoordinateVector latsize = {8, 8, 8, 8};
+
+constexpr double t_evol = 2.0;
+constexpr int n_steps[] = {8, 16, 32, 64, 128};
+constexpr int n_meas = 4;
+
+void update_E(const GaugeField<group> &U, VectorField<Algebra<group>> &E, double delta) {
+    Field<group> staple;
+    foralldir(d) {
+        staplesum(U, staple, d);
+        onsites(ALL) {
+            E[d][X] -= delta * (U[d][X] * staple[X].dagger()).project_to_algebra();
+        }
+    }
+}
+
+void update_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E, double delta) {
+#pragma omp parallel
+#pragma omp master
+    foralldir(d) {
+#pragma hila omp_task
+        onsites(ALL) U[d][X] = exp(E[d][X] * delta) * U[d][X];
+    }
+}
+
+double energy(const GaugeField<group> &U, const VectorField<Algebra<group>> &E) {
+    double e2 = 0;
+    foralldir(d) e2 += E[d].squarenorm();
+    return e2 / 2 + 2.0 * group::size() * measure_plaquettes(U).total();
+}
+
+class realtime_system : public hila::gauge_md_system<group> {
+  public:
+    using hila::gauge_md_system<group>::gauge_md_system;
+
+    void move_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E,
+                double delta) override {
+        update_U(U, E, delta);
+    }
+    void add_force(const GaugeField<group> &U, VectorField<Algebra<group>> &E,
+                   double delta) override {
+        update_E(U, E, delta);
+    }
+};
+
+int main(int argc, char **argv) {
+
+    hila::initialize(argc, argv);
+    lattice.setup(latsize);
+    hila::seed_random(1);
+
+    GaugeField<group> U0;
+    VectorField<Algebra<group>> E0;
+    foralldir(d) {
+        onsites(ALL) {
+            U0[d][X].gaussian_random(0.3).reunitarize();
+            E0[d][X].gaussian_random();
+        }
+    }
+    double H0 = energy(U0, E0);
+
+    hila::out0 << "SU(3) real-time evolution over time " << t_evol << ", energy/site "
+               << H0 / lattice.volume() << "\n";
+    hila::out0 << "scheme            dt      force evals   max |dH|/V     time (s)\n";
+
+    auto &names = hila::integrator_scheme_names();
+    for (int s = 0; s < names.size(); s++) {
+        auto scheme = (hila::integrator_scheme)s;
+        for (int steps : n_steps) {
+            double dt = t_evol / steps;
+            GaugeField<group> U = U0;
+            VectorField<Algebra<group>> E = E0;
+            realtime_system sys(U, E);
+
+            // measure the violation n_meas times during the evolution
+            double dH = 0;
+            double t0 = hila::gettime();
+            for (int m = 0; m < n_meas; m++) {
+                hila::symplectic_integrate(sys, scheme, steps / n_meas, dt);
+                dH = std::max(dH, std::abs(energy(U, E) - H0));
+            }
+            double time = hila::gettime() - t0;
+
+            hila::out0 << string_format("%-16s %7.4f %10d   %12.4e %10.3f\n", names[s].c_str(),
+                                        dt, steps * hila::force_evaluations(scheme),
+                                        dH / lattice.volume(), time);
+        }
+    }
+
+    hila::finishrun();
+}
@@ -0,0 +1,166 @@
+#include "hila.h"
+#include "tools/string_format.h"
+#include <sched.h>
+
+// Per-loop overhead of the persistent thread pool (plumbing/thread_pool.h) compared to
+// an OpenMP parallel region for each loop, at small local volumes where the fork/join
+// cost is comparable to the loop body.  The loops are written here explicitly, so that
+// both are in the same program:
+//   make ARCH=openmp THREAD_POOL=1 bench_loop_overhead
+// Loops: a store of one double per site, y = a x + y on double fields, and a sum
+// reduction.  Times are per loop, in microseconds.
+// Run with pinned threads on a node with at least as many cores as threads, e.g.
+//   OMP_NUM_THREADS=8 OMP_PROC_BIND=close OMP_PLACES=cores ./build/bench_loop_overhead
+// With more threads than cpus the times measure the OS scheduler, not fork/join costs.
+
+CoordinateVector latsize = {8, 8, 8, 8};
+
+constexpr double min_time = 0.5; // seconds per measurement
+
+std::vector<double> xv, yv;
+
+struct store_body {
+    void operator()(int b, int e, int) const {
+        for (int i = b; i < e; i++)
+            yv[i] = i;
+    }
+};
+
+struct axpy_body {
+    double a;
+    void operator()(int b, int e, int) const {
+        for (int i = b; i < e; i++)
+            yv[i] += a * xv[i];
+    }
+};
+
+#if defined(THREAD_POOL)
+struct sum_body {
+    hila::thread_slots<double> &slots;
+    void operator()(int b, int e, int thread) const {
+        double s = 0;
+        for (int i = b; i < e; i++)
+            s += xv[i];
+        slots[thread] = s;
+    }
+};
+#endif
+
+/// time one kind of loop, returns microseconds per loop
+template <typename loop_t>
+double time_loop(loop_t &loop) {
+    double t = 0;
+    long n = 0;
+    for (long reps = 16; t < min_time; reps *= 2) {
+        double t0 = hila::gettime();
+        for (long r = 0; r < reps; r++)
+            loop();
+        t = hila::gettime() - t0;
+        hila::broadcast(t);
+        n = reps;
+    }
+    return 1e6 * t / n;
+}
+
+struct omp_store {
+    void operator()() const {
+        const int sites = lattice.mynode.sites;
+#pragma omp parallel for
+        for (int i = 0; i < sites; i++)
+            yv[i] = i;
+    }
+};
+
+struct omp_axpy {
+    void operator()() const {
+        const int sites = lattice.mynode.sites;
+#pragma omp parallel for
+        for (int i = 0; i < sites; i++)
+            yv[i] += 0.5 * xv[i];
+    }
+};
+
+struct omp_sum {
+    double result;
+    void operator()() {
+        const int sites = lattice.mynode.sites;
+        double s = 0;
+#pragma omp parallel for reduction(+ : s)
+        for (int i = 0; i < sites; i++)
+            s += xv[i];
+        result = s;
+    }
+};
+
+#if defined(THREAD_POOL)
+struct pool_store {
+    void operator()() const {
+        hila::thread_pool::run(0, lattice.mynode.sites, store_body());
+    }
+};
+
+struct pool_axpy {
+    void operator()() const {
+        hila::thread_pool::run(0, lattice.mynode.sites, axpy_body{0.5});
+    }
+};
+
+struct pool_sum {
+    double result;
+    void operator()() {
+        hila::thread_slots<double> slots(0);
+        hila::thread_pool::run(0, lattice.mynode.sites, sum_body{slots});
+        result = 0;
+        slots.add_to(result);
+    }
+};
+#endif
+
+int main(int argc, char **argv) {
+
+    hila::initialize(argc, argv);
+    lattice.setup(latsize);
+
+    xv.assign(lattice.mynode.sites, 1.0);
+    yv.assign(lattice.mynode.sites, 0.0);
+
+    int threads = 1;
+#ifdef OPENMP
+    threads = omp_get_max_threads();
+#endif
+    cpu_set_t cpuset;
+    if (sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0 && CPU_COUNT(&cpuset) < threads)
+        hila::out0 << "WARNING: " << threads << " threads on " << CPU_COUNT(&cpuset)
+                   << " cpus, the times below are not loop overheads\n";
+
+    hila::out0 << "Local volume " << lattice.mynode.sites << ", threads " << threads
+               << ", time per loop (us)\n";
+    hila::out0 << "loop          omp parallel for     thread pool\n";
+
+    omp_store os;
+    omp_axpy oa;
+    omp_sum osum;
+    double t_os = time_loop(os);
+    double t_oa = time_loop(oa);
+    double t_osum = time_loop(osum);
+
+#if defined(THREAD_POOL)
+    pool_store ps;
+    pool_axpy pa;
+    pool_sum psum;
+    double t_ps = time_loop(ps);
+    double t_pa = time_loop(pa);
+    double t_psum = time_loop(psum);
+    if (psum.result != osum.result)
+        hila::out0 << "Sums differ: " << psum.result << " " << osum.result << '\n';
+#else
+    double t_ps = 0, t_pa = 0, t_psum = 0;
+    hila::out0 << "Compiled without THREAD_POOL, thread pool not measured\n";
+#endif
+
+    hila::out0 << string_format("store      %14.3f %16.3f\n", t_os, t_ps);
+    hila::out0 << string_format("axpy       %14.3f %16.3f\n", t_oa, t_pa);
+    hila::out0 << string_format("sum        %14.3f %16.3f\n", t_osum, t_psum);
+
+    hila::finishrun();
+}
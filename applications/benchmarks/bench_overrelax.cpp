@@ -0,0 +1,75 @@
+#include "hila.h"
+#include "gauge/sun_overrelax.h"
+
+// Benchmark SU(N) overrelaxation methods for N = 3..8: SU(2) subgroups,
+// de Forcrand-Jahn (SVD) and polar decomposition (Newton iteration).
+// Staples are sums of 6 random SU(N) matrices; beta is chosen so that
+// beta/N * |S| is of the order seen in pure gauge runs.
+// Prints updates per second per rank and acceptance.
+
+CoordinateVector latsize = {16, 16, 16, 16};
+
+// minimum time for each measurement, in seconds
+constexpr double mintime = 1.0;
+
+template <int N>
+void bench_overrelax() {
+    using group = SU<N, double>;
+
+    Field<group> U, S;
+    onsites(ALL) {
+        U[X].random();
+        S[X] = 0;
+        for (int k = 0; k < 6; k++) {
+            group a;
+            a.random();
+            S[X] += a;
+        }
+    }
+    double beta = 2.0 * N * N;
+
+    const char *names[] = {"su2 subgroups", "dFJ", "polar"};
+    for (int method = 0; method < 3; method++) {
+        int64_t n_acc = 0, n_upd = 0;
+        double t0 = hila::gettime(), t;
+        do {
+            Reduction<int64_t> acc = 0;
+            if (method == 0) {
+                // always accepted
+                onsites(ALL) suN_overrelax(U[X], S[X]);
+                n_acc += lattice.volume();
+            } else if (method == 1) {
+                onsites(ALL) acc += suN_overrelax_dFJ(U[X], S[X], beta);
+            } else {
+                onsites(ALL) acc += suN_overrelax_polar(U[X], S[X], beta);
+            }
+            if (method > 0)
+                n_acc += acc.value();
+            n_upd += lattice.volume();
+            hila::synchronize();
+            // all ranks must agree on when to stop
+            t = hila::gettime() - t0;
+            hila::broadcast(t);
+        } while (t < mintime);
+
+        hila::out0 << "SU(" << N << ") " << names[method] << ": "
+                   << n_upd / t / hila::number_of_nodes() << " updates/s/rank, acceptance "
+                   << (double)n_acc / n_upd << '\n';
+    }
+}
+
+int main(int argc, char **argv) {
+
+    hila::initialize(argc, argv);
+    lattice.setup(latsize);
+    hila::seed_random(1);
+
+    bench_overrelax<3>();
+    bench_overrelax<4>();
+    bench_overrelax<5>();
+    bench_overrelax<6>();
+    bench_overrelax<7>();
+    bench_overrelax<8>();
+
+    hila::finishrun();
+}
@@ -0,0 +1,22 @@
+#include "hila.h"
+
+// Benchmark the lattice setup: layout, neighbour arrays and communication lists.
+// Use a large node volume (few MPI ranks), and in OpenMP builds (ARCH=openmp)
+// vary OMP_NUM_THREADS.  The timer report at the end gives the break-down.
+
+CoordinateVector latsize = {48, 48, 48, 48};
+
+int main(int argc, char **argv) {
+
+    hila::initialize(argc, argv);
+
+    double t = hila::gettime();
+    lattice.setup(latsize);
+    t = hila::gettime() - t;
+    hila::broadcast(t);
+
+    hila::out0 << "Lattice setup: " << t << " s, node volume " << lattice.mynode.sites
+               << " sites\n";
+
+    hila::finishrun();
+}
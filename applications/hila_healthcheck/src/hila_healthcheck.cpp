@@ -50,6 +50,26 @@ void test_functions() {
 
     df[ALL] = sin(X.x() * 2 * M_PI / lattice.size(e_x));
     report_pass("Field functions: sin", df.sum(), 1e-8);
+
+    // memory accounting follows Field allocation and free
+    int64_t mem0 = hila::memory_in_use();
+    // vectorized types are allocated in the vector layout, with its own halo
+#ifdef VECTORIZED
+    using vf_type = Vector<4, double>;
+    int64_t expected = sizeof(vf_type) *
+                       lattice.backend_lattice
+                           ->get_vectorized_lattice<hila::vector_info<vf_type>::vector_size>()
+                           ->field_alloc_size();
+#else
+    int64_t expected = sizeof(Vector<4, double>) * lattice.field_alloc_size();
+#endif
+    {
+        Field<Vector<4, double>> vf = 0;
+        report_pass("Memory accounting of Field allocation",
+                    std::abs(double(hila::memory_in_use() - mem0 - expected)), 0.5);
+    }
+    report_pass("Memory accounting of Field free", std::abs(double(hila::memory_in_use() - mem0)),
+                0.5);
 }
 
 
@@ -82,6 +102,24 @@ void check_reductions() {
     }
     report_pass("Vector reduction, sum " + hila::prettyprint(sum), abs(sum), 1e-4);
 
+    // slice (profile) sum
+    auto prof = f.slice_sum(e_x);
+    sum = 0;
+    for (int i = 0; i < lattice.size(e_x); i++) {
+        sum += expi(2 * M_PI * i / lattice.size(e_x)) -
+               prof[i] / (lattice.volume() / lattice.size(e_x));
+    }
+    report_pass("Slice sum, sum " + hila::prettyprint(sum), abs(sum), 1e-4);
+
+#if !(defined(CUDA) || defined(HIP))
+    // loop over a plane region
+    sum = 0;
+    onsites(SiteRegion::plane(e_x, 1)) sum += f[X];
+    sum /= lattice.volume() / lattice.size(e_x);
+    report_pass("SiteRegion plane loop, sum " + hila::prettyprint(sum),
+                abs(sum - expi(2 * M_PI / lattice.size(e_x))), 1e-4);
+#endif
+
     // do a combined reduction too
     sum = 0;
     rv = 0;
@@ -152,6 +190,27 @@ void test_minmax() {
     v = n.min(loc);
     report_pass("Minloc is " + hila::prettyprint(loc.transpose()), (c - loc).norm(), 1e-8);
     report_pass("Min value " + hila::prettyprint(v), v + 1, 1e-9);
+
+    // single-pass statistics, same min/max and locations
+    CoordinateVector maxloc;
+    n.max(maxloc);
+    auto st = n.statistics(ALL, -1.0, 2.0, 3);
+    report_pass("Statistics min/max and locations",
+                abs(st.min() + 1) + abs(st.max() - 2) + (st.min_location() - loc).norm() +
+                    (st.max_location() - maxloc).norm(),
+                1e-8);
+    report_pass("Statistics mean " + hila::prettyprint(st.mean()),
+                abs(st.mean() - n.sum() / lattice.volume()), 1e-10);
+
+    Field<double> d2;
+    d2[ALL] = sqr(n[X] - st.mean());
+    report_pass("Statistics variance " + hila::prettyprint(st.variance()),
+                abs(st.variance() - d2.sum() / lattice.volume()), 1e-10);
+
+    int64_t hsum = st.underflow() + st.overflow();
+    for (auto h : st.histogram())
+        hsum += h;
+    report_pass("Statistics histogram count", abs(hsum - (int64_t)lattice.volume()), 0.5);
 }
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -233,6 +292,20 @@ void test_set_elements_and_select() {
                     " coordinates",
                 abs(sum), 1e-8);
 
+    // the same through SiteAccessPlan, also add_elements
+    SiteAccessPlan plan(cvec);
+    auto pvals = f.get_elements(plan, true);
+    f.add_elements(pvals, plan);
+    pvals = f.get_elements(plan);
+
+    sum = 0;
+    if (hila::myrank() == 0) {
+        for (int i = 0; i < pvals.size(); i++)
+            sum += pvals[i] - 2.0 * vals[i];
+    }
+    report_pass("SiteAccessPlan get_elements and add_elements", abs(sum), 1e-8);
+    f.set_elements(vals, plan);
+
     // use the same vector for siteselect
 
     SiteSelect s;
@@ -578,6 +651,47 @@ void test_matrix_operations() {
 }
 
 
+//--------------------------------------------------------------------------------
+
+void test_omp_tasks() {
+
+    // loops with #pragma hila omp_task run as OpenMP tasks in the parallel region;
+    // the 2nd loop depends on the 1st one through the gather of a[d].  The 3rd loop is
+    // an ordinary site loop, which waits for the tasks.  The 4th loop has a reduction and
+    // cannot be a task: it waits for the tasks too and runs in this thread
+    VectorField<double> a, b, c;
+    Field<double> f;
+    f[ALL] = X.coordinate(e_x) + 2 * X.coordinate(e_y);
+    double bsum[NDIM];
+
+#pragma omp parallel
+#pragma omp master
+    foralldir(d) {
+#pragma hila omp_task
+        onsites(ALL) a[d][X] = ((int)d + 1) * f[X];
+#pragma hila omp_task
+        onsites(ALL) b[d][X] = a[d][X + d] - a[d][X];
+        onsites(ALL) c[d][X] = a[d][X - d] + b[d][X];
+        double s = 0;
+#pragma hila omp_task
+        onsites(ALL) s += b[d][X] * b[d][X];
+        bsum[d] = s;
+    }
+
+    double diff = 0;
+    foralldir(d) {
+        double s = 0;
+        onsites(ALL) {
+            double v = ((int)d + 1) * (f[X + d] - f[X]);
+            diff += fabs(b[d][X] - v);
+            diff += fabs(c[d][X] - ((int)d + 1) * f[X - d] - v);
+            s += v * v;
+        }
+        diff += fabs(bsum[d] - s);
+    }
+    report_pass("OpenMP task loops", diff, 1e-10);
+}
+
 //--------------------------------------------------------------------------------
 
 void test_matrix_algebra() {
@@ -632,6 +746,24 @@ void test_matrix_algebra() {
     report_pass("Fully pivoted SVD with " + hila::prettyprint(myMatrix::rows()) + "x" +
                     hila::prettyprint(myMatrix::columns()) + " Complex matrix",
                 max_delta, 1e-10);
+
+    // cyclic Jacobi versions, these loops are vectorizable
+
+    onsites(ALL) {
+        auto H = M[X] * M[X].dagger();
+
+        auto r = H.eigen_hermitean_cyclic(hila::sort::ascending);
+        auto s = M[X].svd_cyclic();
+        delta[X] = (H - r.eigenvectors * r.eigenvalues * r.eigenvectors.dagger()).norm() +
+                   (M[X] - s.U * s.singularvalues * s.V.dagger()).norm();
+    }
+
+    max_delta = delta.max();
+
+    report_pass("Cyclic Jacobi eigenvalues and SVD with " +
+                    hila::prettyprint(myMatrix::rows()) + "x" +
+                    hila::prettyprint(myMatrix::columns()) + " Complex matrix",
+                max_delta, 1e-10);
 }
 
 
@@ -675,6 +807,8 @@ int main(int argc, char **argv) {
 
     test_matrix_operations();
 
+    test_omp_tasks();
+
     fft_test();
 
     spectraldensity_test();
@@ -0,0 +1,103 @@
+#include "hila.h"
+#include "tools/multicanonical.h"
+
+// Multicanonical simulation of the 2d Ising model, with the magnetisation as the
+// order parameter.  The weight function is iterated first and then used for
+// measurements; the parameters of the weight iteration are in muca_parameters.
+//
+// Each parity sweep accepts the spin flips with the linear part of the weight,
+// exp(-beta dS - a dM) with a = hila::muca::weight_slope(), and sums the change
+// of the magnetisation in the same site loop.  The sweep as a whole is then
+// accepted or rejected with the non-linear remainder of the weight by
+// hila::muca::accept_reject_increment(), without a separate measurement of M.
+
+double beta = 0.44;
+int n_iteration_sweeps = 100000;
+int n_measurements = 1000;
+int n_sweeps_per_measurement = 10;
+long seed = 123456;
+int NX = 32, NY = 32;
+int VOLUME = NX * NY;
+
+/// Multicanonical update of parity p.  The flips are proposed in trial and
+/// copied to spin if the sweep is accepted
+bool muca_sweep(Field<double> &spin, Field<double> &trial, Parity p) {
+
+    double a = hila::muca::weight_slope();
+    Reduction<double> dM = 0;
+
+    onsites(p) {
+        double deltaS =
+            2.0 * spin[X] * (spin[X + e_x] + spin[X - e_x] + spin[X + e_y] + spin[X - e_y]);
+        double dm = -2.0 * spin[X];
+
+        if (hila::random() < exp(-beta * deltaS - a * dm)) {
+            trial[X] = -spin[X];
+            dM += dm;
+        } else {
+            trial[X] = spin[X];
+        }
+    }
+
+    if (hila::muca::accept_reject_increment(dM.value(), a)) {
+        spin[p] = trial[X];
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+
+    const CoordinateVector nd = {NX, NY};
+    hila::initialize(argc, argv);
+    lattice.setup(nd);
+
+    hila::seed_random(seed);
+
+    Field<double> spin, trial;
+    spin[ALL] = 1;
+
+    hila::muca::initialise("muca_parameters");
+
+    // Iterate the weight function, starting from all spins up
+    hila::muca::set_OP(spin.sum());
+    hila::muca::set_continuous_iteration(true);
+
+    Parity p = EVEN;
+    for (int i = 0; i < n_iteration_sweeps; i++) {
+        muca_sweep(spin, trial, p);
+        p = opp_parity(p);
+        if (i % 1000 == 0 && !hila::muca::check_weight_iter_flag())
+            break;
+    }
+
+    hila::muca::set_continuous_iteration(false);
+    hila::muca::write_weight_function("ising_weights.dat");
+
+    // Measurements with the fixed weights.  set_OP() again to take the slope of the
+    // iterated weights, and to check the tracked magnetisation
+    double M = spin.sum();
+    if (M != hila::muca::get_OP())
+        hila::out0 << "Tracked magnetisation " << hila::muca::get_OP() << " differs from " << M
+                   << '\n';
+    hila::muca::set_OP(M);
+
+    int accepted = 0;
+    for (int i = 0; i < n_measurements; i++) {
+        for (int j = 0; j < 2 * n_sweeps_per_measurement; j++) {
+            if (muca_sweep(spin, trial, p))
+                accepted++;
+            p = opp_parity(p);
+        }
+
+        // magnetisation and the weight for reweighting
+        hila::out0 << "MEAS " << hila::muca::get_OP() / VOLUME << ' '
+                   << hila::muca::current_weight() << '\n';
+    }
+
+    hila::out0 << "Sweep acceptance "
+               << double(accepted) / (2 * n_sweeps_per_measurement * n_measurements) << '\n';
+
+    hila::finishrun();
+    return 0;
+}
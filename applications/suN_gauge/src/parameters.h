@@ -5,6 +5,12 @@ using mygroup = SU<NCOLOR, double>;
 
 enum class poly_limit { OFF, RANGE, PARABOLIC };
 
+// overrelaxation: SU(2) subgroups, de Forcrand-Jahn (SVD) or polar decomposition
+enum class overrelax_method { SU2, DFJ, POLAR };
+
+// measurements as text lines, to a binary measurement log, or both
+enum class measure_output { TEXT, BINARY, BOTH };
+
 
 // define a struct to hold the input parameters: this
 // makes it simpler to pass the values around
@@ -12,12 +18,15 @@ struct parameters {
     double beta;
     double deltab;
     int n_overrelax;
+    overrelax_method or_method;
     int n_update;
     int n_trajectories;
     int n_thermal;
     int n_save;
     int n_profile;
     std::string config_file;
+    measure_output meas_output;
+    std::string meas_file;
     double time_offset;
     poly_limit polyakov_pot;
     double poly_min, poly_max, poly_m2;
@@ -13,6 +13,7 @@
 #include "gauge/sun_heatbath.h"
 #include "gauge/sun_overrelax.h"
 #include "gauge/checkpoint.h"
+#include "tools/measurement_log.h"
 
 
 #include <fftw3.h>
@@ -36,30 +37,23 @@ int z_ind(int z) {
  * @tparam group
  * @param U GaugeField to measure
  * @param p Parameter struct
+ * @param mlog Measurement log with columns "plaq" and "polyakov"
  */
 template <typename group>
-void measure_stuff(const GaugeField<group> &U, const parameters &p) {
-
-    static bool first = true;
-
-    if (first) {
-        hila::out0 << "Legend:";
-        hila::out0 << " plaq  P.real  P.imag\n";
-
-        first = false;
-    }
+void measure_stuff(const GaugeField<group> &U, const parameters &p, hila::measurement_log &mlog) {
 
     auto poly = measure_polyakov(U);
 
     auto plaq = U.measure_plaq() / (lattice.volume() * NDIM * (NDIM - 1) / 2);
 
-    hila::out0 << "MEAS " << std::setprecision(8);
-
-    // write the -(polyakov potential) first, this is used as a weight factor in aa
-
-    hila::out0 << plaq << ' ' << poly << '\n';
+    mlog.set("plaq", plaq);
+    mlog.set("polyakov", poly);
+    mlog.write_row();
 }
 
+// overrelaxation acceptance counters (dFJ and polar methods)
+int64_t or_accepted = 0, or_updates = 0;
+
 /**
  * @brief Wrapper update function
  * @details Updates Gauge Field one direction at a time first EVEN then ODD parity
@@ -115,12 +109,28 @@ void update_parity_dir(GaugeField<group> &U, const parameters &p, Parity par, Di
 
         or_timer.start();
 
-        onsites(par) {
-#ifdef SUN_OVERRELAX_dFJ
-            suN_overrelax_dFJ(U[d][X], staples[X], p.beta);
-#else
-            suN_overrelax(U[d][X], staples[X]);
-#endif
+        if (p.or_method == overrelax_method::SU2) {
+            onsites(par) {
+                suN_overrelax(U[d][X], staples[X]);
+            }
+        } else {
+            Reduction<int64_t> acc = 0;
+            if (p.or_method == overrelax_method::DFJ) {
+                // candidates in a separate loop, which can be vectorized
+                Field<group> Z;
+                onsites(par) {
+                    Z[X] = suN_overrelax_dFJ_candidate(U[d][X], staples[X]);
+                }
+                onsites(par) {
+                    acc += suN_overrelax_accept(U[d][X], Z[X], staples[X], p.beta);
+                }
+            } else {
+                onsites(par) {
+                    acc += suN_overrelax_polar(U[d][X], staples[X], p.beta);
+                }
+            }
+            or_accepted += acc.value();
+            or_updates += lattice.volume() / 2;
         }
         or_timer.stop();
 
@@ -187,6 +197,8 @@ int main(int argc, char **argv) {
     p.deltab = par.get("delta beta fraction");
     // trajectory length in steps
     p.n_overrelax = par.get("overrelax steps");
+    // overrelaxation method: su2 subgroups, dFJ or polar
+    p.or_method = (overrelax_method)par.get_item("overrelax method", {"su2", "dFJ", "polar"});
     p.n_update = par.get("updates in trajectory");
     p.n_trajectories = par.get("trajectories");
     p.n_thermal = par.get("thermalization");
@@ -197,6 +209,11 @@ int main(int argc, char **argv) {
     p.n_save = par.get("traj/saved");
     // measure surface properties and print "profile"
     p.config_file = par.get("config name");
+    // measurements: text lines in output, binary log file, or both
+    p.meas_output =
+        (measure_output)par.get_item("measurement output", {"text", "binary", "both"});
+    if (p.meas_output != measure_output::TEXT)
+        p.meas_file = par.get("measurement file");
 
     par.close(); // file is closed also when par goes out of scope
 
@@ -215,8 +232,19 @@ int main(int argc, char **argv) {
     hila::timer update_timer("Updates");
     hila::timer measure_timer("Measurements");
 
+    // a continued run drops the measurements made after the checkpoint
+    bool from_checkpoint = std::filesystem::exists("run_status");
+
     restore_checkpoint(U, p.config_file, p.n_trajectories, start_traj);
 
+    // MEAS lines / binary log of measurements, appended to when continuing a run
+    hila::measurement_log mlog("MEAS");
+    mlog.add_column<double>("plaq");
+    mlog.add_column<Complex<double>>("polyakov");
+    mlog.text_output(p.meas_output != measure_output::BINARY);
+    if (p.meas_output != measure_output::TEXT)
+        mlog.open(p.meas_file, from_checkpoint);
+
     // We need random number here
     if (!hila::is_rng_seeded())
         hila::seed_random(seed);
@@ -241,7 +269,7 @@ int main(int argc, char **argv) {
 
             hila::out0 << "Measure_start " << trajectory << '\n';
 
-            measure_stuff(U, p);
+            measure_stuff(U, p, mlog);
 
             hila::out0 << "Measure_end " << trajectory << std::endl;
 
@@ -249,9 +277,16 @@ int main(int argc, char **argv) {
         }
 
         if (p.n_save > 0 && (trajectory + 1) % p.n_save == 0) {
+            // measurements up to the checkpoint are written out
+            mlog.checkpoint();
             checkpoint(U, p.config_file, p.n_trajectories, trajectory);
         }
     }
 
+    if (or_updates > 0)
+        hila::out0 << "Overrelax acceptance " << (double)or_accepted / or_updates << '\n';
+
+    mlog.close();
+
     hila::finishrun();
 }
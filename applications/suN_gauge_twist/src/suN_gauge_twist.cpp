@@ -33,8 +33,13 @@ void measure_plaq(const GaugeField<group> &U, const parameters &p) {
 
   static bool first = true;
 
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+  // twist is in the boundary condition of U
+  auto plaq = measure_plaq_with_z(U, 0);
+#else
   auto plaq = measure_plaq_with_z(
       U, p.twist_coeff); /// (lattice.volume() * NDIM * (NDIM - 1) / 2);
+#endif
 
   if (first) {
     hila::out0 << "plaquette: ";
@@ -118,8 +123,11 @@ void update_parity_dir(GaugeField<group> &U, const parameters &p, Parity par,
 
   staples_timer.start();
 
-  // staplesum_twist(U, staples, d, p.twist_coeff,par);
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+  staplesum(U, staples, d, par);
+#else
   staplesum_twist(U, staples, d, p.twist_coeff, par);
+#endif
 
   staples_timer.stop();
 
@@ -221,6 +229,12 @@ int main(int argc, char **argv) {
 
   restore_checkpoint(U, start_traj, p);
 
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+  // twist as a boundary condition, on the plaquettes at the z = t = L-1 corner.
+  // Staples and plaquettes then need no twist-specific code.
+  U.set_twist(e_z, e_t, -p.twist_coeff);
+#endif
+
   // We need random number here
   if (!hila::is_rng_seeded())
     hila::seed_random(seed);
@@ -76,25 +76,27 @@ void staplesum_twist(const GaugeField<T> &U, Field<T> &staples, Direction d1, in
  * @return double
  */
 template <typename T>
-std::vector<double> measure_plaq_with_z(GaugeField<T> U, int twist_coeff) {
+std::vector<double> measure_plaq_with_z(const GaugeField<T> &U, int twist_coeff) {
     Reduction<double> plaq;
     ReductionVector<double> plaq_vec(lattice.size(e_z) + 1);
     plaq_vec = 0;
     plaq.allreduce(false);
     plaq_vec.allreduce(false);
-    GaugeField<double> twist = 0;
-    onsites(ALL) {
-        if (X.z() == 0 && X.t() == 0) {
-            twist[e_z][X] = -twist_coeff;
-        }
-    }
     foralldir(dir1) foralldir(dir2) if (dir1 < dir2) {
 
+        // twist only on z-t plaquettes at z = t = 0
+        Complex<double> twist(1, 0);
+        if (dir1 == e_z && dir2 == e_t)
+            twist = expi(-2 * M_PI * twist_coeff / NCOLOR);
+
         onsites(ALL) {
+            Complex<double> tw(1, 0);
+            if (X.z() == 0 && X.t() == 0)
+                tw = twist;
             double p;
             p = 1.0 -
-                real(expi(2 * M_PI * (twist[dir1][X] / NCOLOR))*trace(U[dir1][X] * U[dir2][X + dir1] * U[dir1][X + dir2].dagger() *
-                           U[dir2][X].dagger() )) /
+                real(tw * trace(U[dir1][X] * U[dir2][X + dir1] * U[dir1][X + dir2].dagger() *
+                                U[dir2][X].dagger())) /
                     T::size();
             plaq += p;
             plaq_vec[X.z()] += p;
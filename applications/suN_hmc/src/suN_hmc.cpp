@@ -22,6 +22,7 @@
 #include "gauge/gradient_flow.h"
 #include "tools/string_format.h"
 #include "tools/floating_point_epsilon.h"
+#include "hmc/symplectic_integrator.h"
 
 
 using ftype = float;
@@ -34,6 +35,7 @@ struct parameters {
     ftype beta;         // inverse gauge coupling
     ftype dt;           // HMC time step
     int trajlen;        // number of HMC time steps per trajectory
+    hila::integrator_scheme integrator; // MD integration scheme
     int n_traj;         // number of trajectories to generate
     int n_therm;        // number of thermalization trajectories (counts only accepted traj.)
     int gflow_freq;     // number of trajectories between gflow measurements
@@ -98,8 +100,11 @@ void update_E(const GaugeField<group> &U, VectorField<Algebra<group>> &E, atype
 
 template <typename group, typename atype = hila::arithmetic_type<group>>
 void update_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E, atype delta) {
-    // evolve U with momentum E over time step delta
+    // evolve U with momentum E over time step delta, directions as OpenMP tasks
+#pragma omp parallel
+#pragma omp master
     foralldir(d) {
+#pragma hila omp_task
         onsites(ALL) U[d][X] = chexp(E[d][X] * delta) * U[d][X];
     }
 }
@@ -133,20 +138,31 @@ atype measure_action(const GaugeField<group> &U, const VectorField<Algebra<group
 }
 
 
-template <typename group, typename atype = hila::arithmetic_type<group>>
-void do_trajectory(GaugeField<group> &U, VectorField<Algebra<group>> &E, const parameters &p) {
-    // leap frog integration for normal action
-
-    // start trajectory: advance U by half a time step
-    update_U(U, E, p.dt / 2);
-    // main trajectory integration:
-    for (int n = 0; n < p.trajlen - 1; ++n) {
-        update_E(U, E, p.beta * p.dt);
-        update_U(U, E, p.dt);
+// MD evolution of (U, E) for the symplectic integrators, with the force of the chosen action
+template <typename group>
+class hmc_md_system : public hila::gauge_md_system<group> {
+  public:
+    using atype = hila::arithmetic_type<group>;
+    atype beta;
+
+    hmc_md_system(GaugeField<group> &U, VectorField<Algebra<group>> &E, atype b)
+        : hila::gauge_md_system<group>(U, E), beta(b) {}
+
+    void move_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E, double eps) override {
+        update_U(U, E, (atype)eps);
     }
-    // end trajectory: bring U and E to the same time
-    update_E(U, E, p.beta * p.dt);
-    update_U(U, E, p.dt / 2);
+
+    void add_force(const GaugeField<group> &U, VectorField<Algebra<group>> &E,
+                   double eps) override {
+        update_E(U, E, (atype)(beta * eps));
+    }
+};
+
+template <typename group>
+void do_trajectory(GaugeField<group> &U, VectorField<Algebra<group>> &E, const parameters &p) {
+    // integrate the MD equations over trajlen steps with the chosen scheme
+    hmc_md_system<group> md(U, E, p.beta);
+    hila::symplectic_integrate(md, p.integrator, p.trajlen, p.dt);
 
     U.reunitarize_gauge();
 }
@@ -282,6 +298,9 @@ int main(int argc, char **argv) {
     p.dt = par.get("dt");
     // trajectory length in steps
     p.trajlen = par.get("trajectory length");
+    // MD integrator: leapfrog, omelyan, yoshida4 or force gradient
+    p.integrator = (hila::integrator_scheme)par.get_item("integrator",
+                                                         hila::integrator_scheme_names());
     // number of trajectories
     p.n_traj = par.get("number of trajectories");
     // number of thermalization trajectories
@@ -1,6 +1,9 @@
 #include "hila.h"
 #include "gauge/staples.h"
 #include "gauge/degauss.h"
+#include "gauge/plaquette_measurements.h"
+#include "tools/unequal_time_correlator.h"
+#include "hmc/symplectic_integrator.h"
 
 #ifndef NSU
     #error "!!! Specify which SU(N) in Makefile: eg. -DNSU=3"
@@ -11,6 +14,22 @@ using SUN = SU<NSU, double>;
 // Output stream for results
 std::ofstream measureFile;
 
+// Number of real components in the electric field at a site, and the field type used for
+// its correlators
+constexpr int n_E = NDIM * sizeof(Algebra<SUN>) / sizeof(double);
+using E_vector = Vector<n_E, double>;
+
+/* Unequal-time correlators of the electric field and the topological charge density,
+* accumulated at the measurement times of the trajectories.  The E correlator is measured
+* in the temporal gauge of the evolution, without further gauge fixing; the chi correlator
+* is gauge invariant. */
+struct correlators {
+    hila::unequal_time_correlator<E_vector> E;
+    hila::unequal_time_correlator<double> chi;
+
+    correlators(int max_lag, int ref_interval) : E(max_lag, ref_interval), chi(max_lag, ref_interval) {}
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 /* Hamiltonian time evolution for gauge and electric fields. 'delta' is the time difference. */
 template <typename group>
@@ -32,12 +51,33 @@ template <typename group>
 void update_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E,
               double delta) {
 
+    // directions are independent, run them as OpenMP tasks
+#pragma omp parallel
+#pragma omp master
     foralldir (d) {
+#pragma hila omp_task
         onsites (ALL)
             U[d][X] = exp(E[d][X] * delta) * U[d][X];
     }
 }
 
+/* Evolution of (U, E) with the symplectic integrators */
+template <typename group>
+class realtime_system : public hila::gauge_md_system<group> {
+  public:
+    using hila::gauge_md_system<group>::gauge_md_system;
+
+    void move_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E,
+                double delta) override {
+        update_U(U, E, delta);
+    }
+
+    void add_force(const GaugeField<group> &U, VectorField<Algebra<group>> &E,
+                   double delta) override {
+        update_E(U, E, delta);
+    }
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename group>
@@ -51,20 +91,7 @@ void regroup_gauge(GaugeField<group> &U) {
 // Total plaquette action (without beta prefactor)
 template <typename group>
 double measure_plaq(const GaugeField<group> &U) {
-
-    Reduction<double> plaq;
-    plaq.allreduce(false).delayed(true);
-
-    foralldir (dir1)
-        foralldir (dir2)
-            if (dir1 < dir2) {
-                onsites (ALL) {
-                    plaq += group::size() - real(trace(U[dir1][X] * U[dir2][X + dir1] *
-                                                       U[dir1][X + dir2].dagger() *
-                                                       U[dir2][X].dagger()));
-                }
-            }
-    return plaq.value();
+    return group::size() * measure_plaquettes(U).total();
 }
 
 
@@ -147,7 +174,8 @@ static double degauss_quality = 1e-12;
 
 // Do the measurements. Here 't' labels the Hamiltonian time 
 template <typename group>
-void measure_stuff(GaugeField<group> &U, VectorField<Algebra<group>> &E, int trajectory, double t) {
+void measure_stuff(GaugeField<group> &U, VectorField<Algebra<group>> &E, int trajectory, double t,
+                   correlators &corr) {
 
     auto plaq = measure_plaq(U); // N - Tr Re P_ij
 
@@ -180,6 +208,16 @@ void measure_stuff(GaugeField<group> &U, VectorField<Algebra<group>> &E, int tra
 
     chi_avg /= lattice.volume();
 
+    // components of E at a site collected into one vector
+    Field<E_vector> Ev;
+    constexpr int n_alg = sizeof(Algebra<group>) / sizeof(double);
+    foralldir(d) onsites(ALL) {
+        for (int i = 0; i < n_alg; i++)
+            Ev[X].e((int)d * n_alg + i) = hila::get_number_in_var(E[d][X], i);
+    }
+    corr.E.add(Ev);
+    corr.chi.add(chi);
+
 
     char buf[1024]; 
     sprintf(buf, "%d %.10g %.8g %.8g %.8g %.8g %.8g", trajectory, t, plaq, e2, viol, energy, chi_avg);
@@ -235,26 +273,59 @@ void thermalize(GaugeField<group> &U, VectorField<Algebra<group>> &E, double g2T
 
 template <typename group>
 void do_trajectory(GaugeField<group> &U, VectorField<Algebra<group>> &E, int trajectory,
-                   int trajlen, int measure_interval, double dt) {
+                   int trajlen, int measure_interval, double dt,
+                   hila::integrator_scheme integrator, correlators &corr) {
+
+    // Correlators do not extend over thermalization
+    corr.E.start();
+    corr.chi.start();
 
     // Measure first at time t=0:
     double t = 0.0;
-    measure_stuff(U, E, trajectory, t);
+    measure_stuff(U, E, trajectory, t, corr);
 
     // Then evolve until we reach t = trajlen*dt
+    realtime_system<group> sys(U, E);
     for (int n = 0; n < trajlen; n += measure_interval) {
-        update_U(U, E, dt / 2);
-        // do 2 time units of evolution with leapfrog
-        for (int steps = 0; steps < measure_interval - 1; steps++) {
-            update_E(U, E, dt);
-            update_U(U, E, dt);
-        }
-        // and bring U and E to the same time value
-        update_E(U, E, dt);
-        update_U(U, E, dt / 2);
-        
+        // evolve measure_interval steps, U and E are at the same time at the end
+        hila::symplectic_integrate(sys, integrator, measure_interval, dt);
+
         t += dt * measure_interval;
-        measure_stuff(U, E, trajectory, t);
+        measure_stuff(U, E, trajectory, t, corr);
+    }
+}
+
+/* Write the correlators C(k, t) as lines "t k C_E C_chi", for each time lag t and k-bin.
+* C is normalized as <Re f(k,t)^* f(k,0)> / V, where f(k) is the Fourier transform. */
+void write_correlators(const std::string &fname, correlators &corr, double dt_meas) {
+
+    // correlator() and k() are called on all ranks, they may need collective operations
+    auto &kb = corr.chi.binning();
+    std::vector<double> k(kb.bins());
+    for (int b = 0; b < kb.bins(); b++)
+        k[b] = kb.k(b);
+
+    std::ofstream corrFile;
+    if (hila::myrank() == 0) {
+        corrFile.open(fname);
+        if (!corrFile) {
+            hila::out0 << "!!! Error opening correlator file " << fname << "\n";
+            return;
+        }
+        corrFile << "# t  k  <E(k,t) E(k,0)>  <chi(k,t) chi(k,0)>\n";
+    }
+
+    for (int lag = 0; lag <= corr.chi.max_lag(); lag++) {
+        auto cE = corr.E.correlator(lag);
+        auto cchi = corr.chi.correlator(lag);
+        if (hila::myrank() == 0 && corr.chi.samples(lag) > 0) {
+            char buf[1024];
+            for (int b = 0; b < k.size(); b++) {
+                sprintf(buf, "%.8g %.8g %.8g %.8g", lag * dt_meas, k[b], cE[b], cchi[b]);
+                corrFile << std::string(buf) << "\n";
+            }
+            corrFile << "\n";
+        }
     }
 }
 
@@ -290,10 +361,15 @@ int main(int argc, char **argv) {
     int trajlen = par.get("trajectory length");
     int n_traj = par.get("number of trajectories");
     int measure_interval = par.get("measurement interval");
+    auto integrator = (hila::integrator_scheme)par.get_item("integrator",
+                                                            hila::integrator_scheme_names());
     int n_thermal = par.get("thermalisation");
     int n_thermal_start = par.get("thermalisation start");
     long seed = par.get("random seed");
     std::string meas_fname = par.get("measurement file");
+    int corr_max_lag = par.get("correlator max lag");
+    int corr_ref_interval = par.get("correlator reference interval");
+    std::string corr_fname = par.get("correlator file");
 
     par.close(); // file is closed also when par goes out of scope
 
@@ -345,6 +421,9 @@ int main(int argc, char **argv) {
     }
      
 
+    // time lags are in units of measurement intervals
+    correlators corr(corr_max_lag, corr_ref_interval);
+
     thermalize(U, E, g2Ta, n_thermal_start, dt);
 
     for (int trajectory = 0; trajectory < n_traj; trajectory++) {
@@ -352,9 +431,11 @@ int main(int argc, char **argv) {
         if (trajectory % 500 == 0) {
             hila::out0 << "Trajectory " << trajectory << "\n";
         }
-        do_trajectory(U, E, trajectory, trajlen, measure_interval, dt);
+        do_trajectory(U, E, trajectory, trajlen, measure_interval, dt, integrator, corr);
     }
 
+    write_correlators(corr_fname, corr, dt * measure_interval);
+
 
     // done
     if (hila::myrank() == 0) {
@@ -48,14 +48,14 @@ void check_forces(fermion_action &fa, dirac &D, gauge_field_type &gauge) {
         D.apply(psi, tmp);
         onsites(D.par) { s1 += chi[X].rdot(tmp[X]); }
 
-        gauge.get_gauge(0).set_element(g12, coord);
+        gauge.modify_gauge(0).set_element(g12, coord);
         gauge.refresh();
 
         double s2 = 0;
         D.apply(psi, tmp);
         onsites(D.par) { s2 += chi[X].rdot(tmp[X]); }
 
-        gauge.get_gauge(0).set_element(g1, coord);
+        gauge.modify_gauge(0).set_element(g1, coord);
         gauge.refresh();
 
         D.force(chi, psi, force, 1);
@@ -85,14 +85,14 @@ void check_forces(fermion_action &fa, dirac &D, gauge_field_type &gauge) {
         D.dagger(psi, tmp);
         onsites(D.par) { s1 += chi[X].rdot(tmp[X]); }
 
-        gauge.get_gauge(0).set_element(g12, coord);
+        gauge.modify_gauge(0).set_element(g12, coord);
         gauge.refresh();
 
         s2 = 0;
         D.dagger(psi, tmp);
         onsites(D.par) { s2 += chi[X].rdot(tmp[X]); }
 
-        gauge.get_gauge(0).set_element(g1, coord);
+        gauge.modify_gauge(0).set_element(g1, coord);
         gauge.refresh();
 
         D.force(chi, psi, force, -1);
@@ -116,11 +116,11 @@ void check_forces(fermion_action &fa, dirac &D, gauge_field_type &gauge) {
         sf1[ALL] = 0;
         sf2[ALL] = 0;
 
-        gauge.get_gauge(0).set_element(g12, coord);
+        gauge.modify_gauge(0).set_element(g12, coord);
         gauge.refresh();
         fa.action(sf2);
 
-        gauge.get_gauge(0).set_element(g1, coord);
+        gauge.modify_gauge(0).set_element(g1, coord);
         gauge.refresh();
         fa.action(sf1);
 
@@ -184,15 +184,21 @@ int main(int argc, char **argv) {
 
         double s1 = ga.action();
 
-        if (hila::myrank() == 0)
-            gauge.gauge[0].set_value_at(g12, 50);
-        gauge.gauge[0].mark_changed(ALL);
+        {
+            Field<SU<N, double>> &U0 = gauge.modify_gauge(0);
+            if (hila::myrank() == 0)
+                U0.set_value_at(g12, 50);
+            U0.mark_changed(ALL);
+        }
 
         double s2 = ga.action();
 
-        if (hila::myrank() == 0)
-            gauge.gauge[0].set_value_at(g1, 50);
-        gauge.gauge[0].mark_changed(ALL);
+        {
+            Field<SU<N, double>> &U0 = gauge.modify_gauge(0);
+            if (hila::myrank() == 0)
+                U0.set_value_at(g1, 50);
+            U0.mark_changed(ALL);
+        }
 
         ga.force_step(1.0);
         SU<N> f = gauge.momentum[0].get_value_at(50);
@@ -147,7 +147,25 @@ void TopLevelVisitor::generate_code(Stmt *S) {
     while (t.find(parity_name, 0) != std::string::npos)
         parity_name += "_";
 
-    if (loop_info.parity_value == Parity::none) {
+    if (loop_info.is_region) {
+        // loop over SiteRegion: take a reference to it (extends the lifetime of
+        // a temporary), and use the parity of the region
+        loop_info.region_str = "_HILA_region";
+        while (t.find(loop_info.region_str, 0) != std::string::npos)
+            loop_info.region_str += "_";
+
+        code << "const SiteRegion & " << loop_info.region_str << " = " << loop_info.parity_text
+             << ";\n";
+        code << "const Parity " << parity_name << " = " << loop_info.region_str
+             << ".parity();\n";
+
+        if (global.assert_loop_parity) {
+            code << "assert( is_even_odd_parity(" << parity_name
+                 << ") && \"Parity should be EVEN or ODD in this loop\");\n";
+        }
+        loop_info.parity_str = parity_name;
+
+    } else if (loop_info.parity_value == Parity::none) {
         // now unknown
         code << "const Parity " << parity_name << " = " << loop_info.parity_text << ";\n";
 
@@ -169,6 +187,35 @@ void TopLevelVisitor::generate_code(Stmt *S) {
         }
     }
 
+    // make the reduction expr list from variables and loop const expressions
+
+    create_reduction_list(var_info_list, loop_const_expr_ref_list);
+
+    // #pragma hila omp_task: the loop is generated as an OpenMP task, see
+    // generate_code_cpu().  Only loops without reductions, random numbers, site selections
+    // or field offsets qualify, others are generated as usual
+    loop_info.is_omp_task = loop_info.has_pragma_omp_task && target.openmp &&
+                            !target.openacc && !target.kernelize &&
+                            !loop_info.has_pragma_omp_parallel_region &&
+                            !loop_info.contains_random && !loop_info.is_region &&
+                            selection_info_list.empty();
+    for (reduction_expr &r : reduction_list)
+        if (r.reduction_type != reduction::NONE)
+            loop_info.is_omp_task = false;
+    for (array_ref &ar : array_ref_list)
+        if (ar.type == array_ref::REDUCTION)
+            loop_info.is_omp_task = false;
+    for (field_info &l : field_info_list)
+        if (l.is_read_offset)
+            loop_info.is_omp_task = false;
+
+    // The other omp_task loops wait for the earlier tasks.  In a parallel region they run
+    // serially in the thread creating the tasks, instead of opening a nested parallel
+    // region, see generate_code_cpu()
+    loop_info.is_omp_task_serial = loop_info.has_pragma_omp_task && !loop_info.is_omp_task &&
+                                   target.openmp && !target.openacc && !target.kernelize &&
+                                   !loop_info.has_pragma_omp_parallel_region;
+
     // then, generate new names for field variables in loop
 
     for (field_info &l : field_info_list) {
@@ -232,12 +279,23 @@ void TopLevelVisitor::generate_code(Stmt *S) {
 
     bool first = true;
     bool generate_wait_loops;
-    if (cmdline::no_interleaved_comm)
+    if (cmdline::no_interleaved_comm || loop_info.is_omp_task || loop_info.is_omp_task_serial)
         generate_wait_loops = false;
     else
         generate_wait_loops = true;
 
+    // Other loops wait for all earlier omp_task tasks before the fields are gathered or
+    // used.  Outside task regions taskwait does nothing
+    if (target.openmp && !target.openacc && !target.kernelize && !loop_info.is_omp_task)
+        code << "#pragma omp taskwait\n";
+
     for (field_info &l : field_info_list) {
+        // Task loops gather in the thread creating the tasks (MPI calls stay in the master
+        // thread), after the earlier tasks writing the field are done
+        if (loop_info.is_omp_task && l.dir_list.size() > 0) {
+            code << "#pragma omp taskwait depend(in: " << l.new_name << ".fs[0])\n";
+        }
+
         // If neighbour references exist, communicate them
         if (!l.is_loop_local_dir) {
             // "normal" dir references only here
@@ -289,9 +347,6 @@ void TopLevelVisitor::generate_code(Stmt *S) {
         generate_wait_loops = false; // no communication needed in the 1st place
 
     /////////////////////////////////////////////////////////////////////
-    // make the reduction expr list from variables and loop const expressions
-
-    create_reduction_list(var_info_list, loop_const_expr_ref_list);
 
     // Create a temporary reduction variable and initialize
     for (reduction_expr &r : reduction_list) {
@@ -412,10 +467,12 @@ void TopLevelVisitor::generate_code(Stmt *S) {
         }
     }
 
-    // finally mark modified fields
+    // finally mark modified fields - region loops do not mark the parity assigned
     for (field_info &l : field_info_list)
         if (l.is_written) {
-            code << l.new_name << ".mark_changed(" << loop_info.parity_str << ");\n";
+            code << l.new_name
+                 << (loop_info.is_region ? ".mark_changed_region(" : ".mark_changed(")
+                 << loop_info.parity_str << ");\n";
         }
 
     // and close
@@ -243,6 +243,7 @@ static bool are_vectors_compatible(const vectorization_info &vecinfo, const std:
 ///       vector type.  Otherwise leads to missing type conversions
 ///  TODO: Rectify this issue!
 ///  d) no site selection operation in the loop
+///  e) not a SiteRegion loop
 ///////////////////////////////////////////////////////////////////////////////////
 
 bool TopLevelVisitor::check_loop_vectorizable(Stmt *S, int &vector_size_, std::string &diag_str) {
@@ -276,6 +277,11 @@ bool TopLevelVisitor::check_loop_vectorizable(Stmt *S, int &vector_size_, std::s
             reason.push_back("it contains site selection variable");
         }
 
+        if (loop_info.is_region) {
+            is_vectorizable = false;
+            reason.push_back("it is a loop over SiteRegion");
+        }
+
         // check if the fields are vectorizable in a compatible manner
         for (field_info &fi : field_info_list) {
             if (!fi.vecinfo.is_vectorizable) {
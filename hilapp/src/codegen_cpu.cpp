@@ -30,9 +30,15 @@ std::string TopLevelVisitor::generate_code_cpu(Stmt *S, bool semicolon_at_end, s
 
     code << "const lattice_struct & loop_lattice = lattice;\n";
 
-    // Set the start and end points
-    code << "const int loop_begin = loop_lattice.loop_begin(" << loop_info.parity_str << ");\n";
-    code << "const int loop_end   = loop_lattice.loop_end(" << loop_info.parity_str << ");\n";
+    // Set the start and end points - region loops run over the region site list
+    if (loop_info.is_region) {
+        code << "const int loop_begin = 0;\n";
+        code << "const int loop_end   = " << loop_info.region_str << ".size();\n";
+    } else {
+        code << "const int loop_begin = loop_lattice.loop_begin(" << loop_info.parity_str
+             << ");\n";
+        code << "const int loop_end   = loop_lattice.loop_end(" << loop_info.parity_str << ");\n";
+    }
 
     // are there
 
@@ -40,10 +46,90 @@ std::string TopLevelVisitor::generate_code_cpu(Stmt *S, bool semicolon_at_end, s
         code << "for (int _wait_i_ = 0; _wait_i_ < 2; ++_wait_i_) {\n";
     }
 
+    std::stringstream task_header;
+
+    // Loops on the persistent thread pool (hilapp -thread-pool), see
+    // plumbing/thread_pool.h.  Loops which would not be parallel with OpenMP, loops
+    // with site selections or vector reductions and loops in omp parallel regions are
+    // generated as usual
+    bool pool_loop = target.thread_pool && !loop_info.is_omp_task &&
+                     !loop_info.contains_random && !loop_info.has_pragma_omp_parallel_region &&
+                     selection_info_list.empty();
+    for (array_ref &ar : array_ref_list)
+        if (ar.type == array_ref::REDUCTION)
+            pool_loop = false;
+
+    std::string loop_begin_str = "loop_begin", loop_end_str = "loop_end";
+
     // and the openacc loop header
     if (target.openacc) {
         generate_openacc_loop_header(code);
+    } else if (pool_loop) {
+        // The loop body is a lambda called with a chunk of the loop range on each thread.
+        // Reduction variables are thread local within the lambda, and the per-thread
+        // results are combined in thread order after the loop
+        for (reduction_expr &r : reduction_list) {
+            if (r.reduction_type != reduction::NONE) {
+                code << "hila::thread_slots<" << r.type << "> " << r.reduction_name
+                     << "slots_(" << (r.reduction_type == reduction::PRODUCT ? "1" : "0")
+                     << ");\n";
+            }
+        }
+        code << "hila::thread_pool::run(loop_begin, loop_end, [&](const int _HILA_chunk_begin_, "
+                "const int _HILA_chunk_end_, const int _HILA_thread_) {\n";
+        for (reduction_expr &r : reduction_list) {
+            if (r.reduction_type != reduction::NONE) {
+                code << r.type << " " << r.reduction_name << ";\n";
+                code << r.reduction_name << " = "
+                     << (r.reduction_type == reduction::PRODUCT ? "1" : "0") << ";\n";
+            }
+        }
+        loop_begin_str = "_HILA_chunk_begin_";
+        loop_end_str = "_HILA_chunk_end_";
+
+    } else if (loop_info.is_omp_task) {
+        // #pragma hila omp_task loop.  Within an OpenMP parallel region (opened with
+        //   #pragma omp parallel
+        //   #pragma omp master
+        // around the loops) the loop is an OpenMP task, which depends on the earlier tasks
+        // writing the fields read here and on the tasks accessing the fields written here.
+        // The field references and the lattice are shared, variables declared in this
+        // block are copied.  Outside parallel regions the loop is a normal omp loop.
+        // omp_task loops which cannot be tasks (reductions, selections, ...) wait for the
+        // earlier tasks and run serially in this thread.  Site loops without the pragma
+        // wait for the tasks too, and run as nested (serial) parallel regions.
+        task_header << "#pragma omp task shared(loop_lattice";
+        for (field_info &l : field_info_list)
+            task_header << ", " << l.new_name;
+        task_header << ") firstprivate(loop_begin, loop_end";
+        if (loop_info.parity_str == parity_name)
+            task_header << ", " << parity_name;
+        for (loop_const_expr_ref &lcer : loop_const_expr_ref_list)
+            if (lcer.reduction_type == reduction::NONE)
+                task_header << ", " << lcer.new_name;
+        task_header << ")";
+
+        bool first = true;
+        for (field_info &l : field_info_list)
+            if (!l.is_written) {
+                task_header << (first ? " depend(in: " : ", ") << l.new_name << ".fs[0]";
+                first = false;
+            }
+        if (!first)
+            task_header << ")";
+        first = true;
+        for (field_info &l : field_info_list)
+            if (l.is_written) {
+                task_header << (first ? " depend(inout: " : ", ") << l.new_name << ".fs[0]";
+                first = false;
+            }
+        if (!first)
+            task_header << ")";
+        task_header << '\n';
+
     } else if (target.openmp && !loop_info.contains_random) {
+        // the omp header of a serial omp_task loop is used only outside parallel regions
+        std::stringstream &omp_header = loop_info.is_omp_task_serial ? task_header : code;
         int sums = 0;
         for (reduction_expr &r : reduction_list) {
             if (r.reduction_type != reduction::NONE &&
@@ -54,29 +140,41 @@ std::string TopLevelVisitor::generate_code_cpu(Stmt *S, bool semicolon_at_end, s
             }
         }
         if (loop_info.has_pragma_omp_parallel_region)
-            code << "#pragma omp for";
+            omp_header << "#pragma omp for";
         else
-            code << "#pragma omp parallel for";
+            omp_header << "#pragma omp parallel for";
 
         sums = 0;
         for (reduction_expr &r : reduction_list) {
             if (r.reduction_type != reduction::NONE) {
-                code << " reduction(";
+                omp_header << " reduction(";
                 if (get_number_type(r.type) == number_type::UNKNOWN) {
-                    code << "_hila_reduction_sum" << sums;
+                    omp_header << "_hila_reduction_sum" << sums;
                 } else {
-                    code << '+';
+                    omp_header << '+';
                 }
-                code << ": " << r.reduction_name << ")";
+                omp_header << ": " << r.reduction_name << ")";
             }
         }
-        code << '\n';
+        omp_header << '\n';
     }
 
 
+    // task loops are written twice, see above: collect the loop separately
+    std::stringstream pre_loop;
+    if (loop_info.is_omp_task || loop_info.is_omp_task_serial)
+        pre_loop.swap(code);
+
     // Start the loop
-    code << "for(int " << looping_var << " = loop_begin; " << looping_var << " < loop_end; ++"
-         << looping_var << ") {\n";
+    if (loop_info.is_region) {
+        code << "for(int _HILA_region_i_ = " << loop_begin_str << "; _HILA_region_i_ < "
+             << loop_end_str << "; ++_HILA_region_i_) {\n";
+        code << "const int " << looping_var << " = " << loop_info.region_str
+             << ".site_index(_HILA_region_i_);\n";
+    } else {
+        code << "for(int " << looping_var << " = " << loop_begin_str << "; " << looping_var
+             << " < " << loop_end_str << "; ++" << looping_var << ") {\n";
+    }
 
     if (generate_wait_loops) {
         code << "if (((loop_lattice.wait_arr_[" << looping_var
@@ -95,13 +193,13 @@ std::string TopLevelVisitor::generate_code_cpu(Stmt *S, bool semicolon_at_end, s
         if (si.assign_expr == nullptr) {
             loopBuf.replace(si.MCE, si.new_name +
                                         ".select_site(SiteIndex(loop_lattice.coordinates(" +
-                                        looping_var + ")))");
+                                        looping_var + ")), " + looping_var + ")");
         } else {
             SourceRange r(si.MCE->getSourceRange().getBegin(),
                           si.assign_expr->getSourceRange().getBegin().getLocWithOffset(-1));
             loopBuf.replace(r, si.new_name +
                                    ".select_site_value(SiteIndex(loop_lattice.coordinates(" +
-                                   looping_var + ")), ");
+                                   looping_var + ")), " + looping_var + ", ");
         }
     }
 
@@ -237,9 +335,45 @@ std::string TopLevelVisitor::generate_code_cpu(Stmt *S, bool semicolon_at_end, s
 
     code << "}\n";
 
+    // with wait loops the above closed the if (), close also the loop
+    if (generate_wait_loops)
+        code << "}\n";
+
+    if (pool_loop) {
+        for (reduction_expr &r : reduction_list) {
+            if (r.reduction_type != reduction::NONE) {
+                code << r.reduction_name << "slots_[_HILA_thread_] = " << r.reduction_name
+                     << ";\n";
+            }
+        }
+        code << "});\n";
+        for (reduction_expr &r : reduction_list) {
+            if (r.reduction_type == reduction::SUM) {
+                code << r.reduction_name << "slots_.add_to(" << r.reduction_name << ");\n";
+            } else if (r.reduction_type == reduction::PRODUCT) {
+                code << r.reduction_name << "slots_.multiply_to(" << r.reduction_name << ");\n";
+            }
+        }
+    }
+
+    if (loop_info.is_omp_task) {
+        std::string loop = code.str();
+        code.swap(pre_loop);
+        code << "if (omp_in_parallel()) {\n"
+             << task_header.str() << loop << "} else {\n#pragma omp parallel for\n"
+             << loop << "}\n";
+    } else if (loop_info.is_omp_task_serial) {
+        // no nested parallel region: in a parallel region the loop is run by this thread
+        std::string loop = code.str();
+        code.swap(pre_loop);
+        code << "if (omp_in_parallel()) {\n"
+             << loop << "} else {\n"
+             << task_header.str() << loop << "}\n";
+    }
+
     if (generate_wait_loops) {
-        // add the code for 2nd round - also need one } to balance the if ()
-        code << "}\nif (_dir_mask_ == 0) break;    // No need for another round\n";
+        // add the code for 2nd round
+        code << "if (_dir_mask_ == 0) break;    // No need for another round\n";
 
         for (field_info &l : field_info_list) {
             // If neighbour references exist, communicate them
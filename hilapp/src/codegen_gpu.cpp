@@ -127,6 +127,13 @@ std::string TopLevelVisitor::generate_code_gpu(Stmt *S, bool semicolon_at_end, s
     // indexing variable
     extern std::string looping_var;
 
+    if (loop_info.is_region) {
+        reportDiag(DiagnosticsEngine::Level::Error,
+                   loop_info.parity_expr->getSourceRange().getBegin(),
+                   "onsites(SiteRegion) loops are not supported on GPU targets");
+        return "";
+    }
+
 
     // Get kernel name - use line number or file offset (must be deterministic)
     std::string kernel_name = TopLevelVisitor::make_kernel_name();
@@ -91,6 +91,12 @@ llvm::cl::opt<bool> cmdline::no_interleaved_comm(
     "no-interleave", llvm::cl::desc("Do not interleave communications with computation"),
     llvm::cl::cat(HilappCategory));
 
+llvm::cl::opt<bool> cmdline::thread_pool(
+    "thread-pool",
+    llvm::cl::desc("With -target:openmp, run site loops on the persistent hila thread pool\n"
+                   "instead of a new omp parallel region for each loop (needs -DTHREAD_POOL)"),
+    llvm::cl::cat(HilappCategory));
+
 llvm::cl::opt<bool> cmdline::check_initialization(
     "check-init",
     llvm::cl::desc("Insert checks that Field variables are appropriately initialized before use"),
@@ -199,6 +205,7 @@ void handle_cmdline_arguments(codetype &target) {
         target.vector_size = cmdline::vectorize;
     } else if (cmdline::c_openmp) {
         target.openmp = true;
+        target.thread_pool = cmdline::thread_pool;
     }
 
     if (cmdline::CUDA || cmdline::HIP)
@@ -250,7 +257,8 @@ struct pragma_types {
 static std::vector<pragma_types> pragma_hila_types{
     {"skip", false},         {"ast_dump", false},        {"loop_function", false},
     {"novector", false},     {"nonvectorizable", false}, {"contains_rng", false},
-    {"direct_access", true}, {"safe_access", true},      {"omp_parallel_region", false}};
+    {"direct_access", true}, {"safe_access", true},      {"omp_parallel_region", false},
+    {"omp_task", false}};
 
 void check_pragmas(std::string &arg, SourceLocation prloc, SourceLocation refloc,
                    std::vector<pragma_loc_struct> &pragmas) {
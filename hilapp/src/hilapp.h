@@ -50,6 +50,7 @@ struct codetype {
     int vector_size = 1;
     bool openacc = false;
     bool openmp = false;
+    bool thread_pool = false;
     bool kernelize = false;
     bool GPU = false;
 };
@@ -80,6 +81,7 @@ extern llvm::cl::opt<bool> c_openmp;
 // extern llvm::cl::opt<bool> func_attribute;
 extern llvm::cl::opt<int> vectorize;
 extern llvm::cl::opt<bool> no_interleaved_comm;
+extern llvm::cl::opt<bool> thread_pool;
 // extern llvm::cl::opt<bool> no_mpi;
 extern llvm::cl::opt<int> verbosity;
 extern llvm::cl::opt<int> avx_info;
@@ -398,10 +400,16 @@ struct loop_info_struct {
     std::string parity_str;  // what string to use
     Parity parity_value;
 
+    bool is_region;          // onsites(SiteRegion) -loop
+    std::string region_str;  // name of the region variable in generated code
+
     bool has_pragma_novector;
     bool has_pragma_access;
     bool has_pragma_safe;
     bool has_pragma_omp_parallel_region;
+    bool has_pragma_omp_task;
+    bool is_omp_task;                         // loop is generated as an OpenMP task
+    bool is_omp_task_serial;                  // omp_task loop which cannot be a task
     const char *pragma_access_args;
     const char *pragma_safe_args;
     bool has_site_dependent_cond_or_index;    // if, for, while w. site dep. cond?
@@ -513,7 +521,8 @@ enum class pragma_hila {
     CONTAINS_RNG,
     ACCESS,
     SAFE,
-    IN_OMP_PARALLEL_REGION
+    IN_OMP_PARALLEL_REGION,
+    OMP_TASK
 };
 
 /// Pragma handling things
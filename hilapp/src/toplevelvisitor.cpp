@@ -1953,7 +1953,9 @@ bool TopLevelVisitor::VisitStmt(Stmt *s) {
             has_pragma(s, pragma_hila::ACCESS, &loop_info.pragma_access_args);
         loop_info.has_pragma_omp_parallel_region =
             has_pragma(s, pragma_hila::IN_OMP_PARALLEL_REGION);
+        loop_info.has_pragma_omp_task = has_pragma(s, pragma_hila::OMP_TASK);
         loop_info.has_pragma_safe = has_pragma(s, pragma_hila::SAFE, &loop_info.pragma_safe_args);
+        loop_info.is_region = false;
 
         DeclStmt *init = dyn_cast<DeclStmt>(f->getInit());
         if (init && init->isSingleDecl()) {
@@ -1962,10 +1964,24 @@ bool TopLevelVisitor::VisitStmt(Stmt *s) {
                 const Expr *ie = vd->getInit();
                 if (ie) {
                     loop_info.parity_expr = ie;
-                    loop_info.parity_value = get_parity_val(loop_info.parity_expr);
                     loop_info.parity_text = remove_initial_whitespace(
                         macro.substr(site_loop_name.length(), std::string::npos));
 
+                    // Is the argument SiteRegion, converted to Parity?
+                    const Expr *arg = ie->IgnoreImplicit();
+                    if (const CXXMemberCallExpr *MCE = dyn_cast<CXXMemberCallExpr>(arg)) {
+                        if (isa<CXXConversionDecl>(MCE->getMethodDecl()) &&
+                            get_expr_type(MCE->getImplicitObjectArgument())
+                                    .find("SiteRegion") != std::string::npos) {
+                            loop_info.is_region = true;
+                        }
+                    }
+
+                    if (loop_info.is_region)
+                        loop_info.parity_value = Parity::none;
+                    else
+                        loop_info.parity_value = get_parity_val(loop_info.parity_expr);
+
                     global.full_loop_text = macro + " " + get_stmt_str(f->getBody());
 
                     // Delete "onsites()" -text
@@ -2005,9 +2021,13 @@ bool TopLevelVisitor::VisitStmt(Stmt *s) {
     if (found) {
 
         loop_info.has_pragma_novector = has_pragma(s, pragma_hila::NOVECTOR);
+        loop_info.is_region = false;
         loop_info.has_pragma_access =
             has_pragma(s, pragma_hila::ACCESS, &loop_info.pragma_access_args);
         loop_info.has_pragma_safe = has_pragma(s, pragma_hila::SAFE, &loop_info.pragma_safe_args);
+        loop_info.has_pragma_omp_parallel_region =
+            has_pragma(s, pragma_hila::IN_OMP_PARALLEL_REGION);
+        loop_info.has_pragma_omp_task = has_pragma(s, pragma_hila::OMP_TASK);
 
         SourceRange full_range = getRangeWithSemicolon(s, false);
         global.full_loop_text = TheRewriter.getRewrittenText(full_range);
@@ -750,6 +750,12 @@ using complex_x_scalar_type = typename complex_x_scalar_s<A, B>::type;
 //     return (Complex<hila::arithmetic_type<T>> *)(void *)&var;
 // }
 
+/// lane_select for complex numbers, see plumbing/real_var_ops.h
+template <typename M, typename T>
+inline Complex<T> lane_select(const M &mask, const Complex<T> &a, const Complex<T> &b) {
+    return Complex<T>(lane_select(mask, a.re, b.re), lane_select(mask, a.im, b.im));
+}
+
 ////////////////////////////////////////////////////////////////////////
 // get_complex_element(var,i)
 //    returns the i:th complex number embedded in variable v
@@ -1309,6 +1309,22 @@ class Matrix_t {
         static_assert(hila::is_floating_point<hila::arithmetic_type<T>>::value,
                       "Matrix/Vector gaussian_random() requires non-integral type elements");
 
+#if !defined(CUDA) && !defined(HIP)
+        // fill all real components with one batched call.  The order of the
+        // numbers is the same as in the element-by-element fill below
+        using atype = hila::arithmetic_type<T>;
+        constexpr int nr = n * m * (hila::is_complex<T>::value ? 2 : 1);
+        static_assert(sizeof(c) == nr * sizeof(atype), "Unexpected Matrix element layout");
+        atype *a = reinterpret_cast<atype *>(c);
+        if constexpr (std::is_same<atype, double>::value) {
+            hila::gaussrand_array(a, nr, width);
+        } else {
+            double buf[nr];
+            hila::gaussrand_array(buf, nr, width);
+            for (int i = 0; i < nr; i++)
+                a[i] = buf[i];
+        }
+#else
         // for Complex numbers gaussian_random fills re and im efficiently
         if constexpr (hila::is_complex<T>::value) {
             for (int i = 0; i < n * m; i++) {
@@ -1327,6 +1343,7 @@ class Matrix_t {
                 c[n * m - 1] = hila::gaussrand() * width;
             }
         }
+#endif
         return *this;
     }
 
@@ -1519,7 +1536,6 @@ class Matrix_t {
 
 #pragma hila novector
     T det_lu() const;
-#pragma hila novector
     T det_laplace() const;
 #pragma hila novector
     T det() const;
@@ -1572,6 +1588,27 @@ class Matrix_t {
 
     svd_result<Mtype> svd_pivot(enum hila::sort sorted = hila::sort::unsorted) const;
 
+    /**
+     * @brief Eigenvalues and -vectors of hermitean matrix and SVD with cyclic Jacobi sweeps
+     * @details Same interface as eigen_hermitean() and svd(), but the rotations follow a fixed
+     * cyclic schedule and converged elements are masked out instead of branched around.
+     * These can be used in vectorized (AVX) site loops.  Return the number of sweeps.
+     */
+    template <typename Et, typename Mt, typename MT>
+    int eigen_hermitean_cyclic(out_only DiagonalMatrix<n, Et> &eigenvalues,
+                               out_only Matrix_t<n, n, Mt, MT> &eigenvectors,
+                               enum hila::sort sorted = hila::sort::unsorted) const;
+
+    eigen_result<Mtype>
+    eigen_hermitean_cyclic(enum hila::sort sorted = hila::sort::unsorted) const;
+
+    template <typename Et, typename Mt, typename MT>
+    int svd_cyclic(out_only Matrix_t<n, n, Mt, MT> &_U, out_only DiagonalMatrix<n, Et> &_D,
+                   out_only Matrix_t<n, n, Mt, MT> &_V,
+                   enum hila::sort sorted = hila::sort::unsorted) const;
+
+    svd_result<Mtype> svd_cyclic(enum hila::sort sorted = hila::sort::unsorted) const;
+
 
     //////// matrix_linalg.h
 
@@ -2619,6 +2656,7 @@ inline void chexp(const Matrix_t<n, m, T, MT> &mat, out_only Matrix_t<n, m, T, M
     // would have at iteration i, if no renormalization were used.
     T ch, cho;                            // temporary variables for iteration
     hila::arithmetic_type<T> s, rs = 1.0; // temp variables used for renormalization of pal[]
+    hila::arithmetic_type<T> one = 1.0;
     ttwpf = twpf;
     for (j = n; j < mmax; ++j) {
         pal[n - 1] *= rs;
@@ -2635,18 +2673,15 @@ inline void chexp(const Matrix_t<n, m, T, MT> &mat, out_only Matrix_t<n, m, T, M
             al[i] += wpf * ch;
         }
 
-        if (s > 1.0) {
-            // if s is bigger than 1, normalize pal[] by a factor rs=1.0/s in next itaration,
-            // and multiply wpf by s to compensate
-            s = std::sqrt(s);
-            wpf *= s / (j + 1);
-            rs = 1.0 / s;
-        } else {
-            wpf /= (j + 1);
-            rs = 1.0;
-        }
+        // if s is bigger than 1, normalize pal[] by a factor rs=1.0/s in next itaration,
+        // and multiply wpf by s to compensate.  Selected lane by lane, so that this can be
+        // used in vectorized loops
+        auto renorm = s > 1.0;
+        s = sqrt(s);
+        wpf = hila::lane_select(renorm, wpf * (s / (j + 1)), wpf / (j + 1));
+        rs = hila::lane_select(renorm, one / s, one);
         twpf += wpf;
-        if (ttwpf == twpf) {
+        if (hila::all_lanes(ttwpf == twpf)) {
             // terminate iteration when numeric value of twpf stops changing
             break;
         }
@@ -2,6 +2,7 @@
 #define MATRIX_LINALG_H
 
 #include "datatypes/matrix.h"
+#include "tools/floating_point_epsilon.h"
 
 #include <limits>
 
@@ -39,10 +40,10 @@ inline double find_largest_offdiag(const SquareMatrix<n, Mtype> &M, int &p, int
  * where the "Givens" is taken to be unity except on row/col = p,q
  */
 
-template <typename Dtype>
+template <typename Dtype, typename Rtype = double>
 struct GivensMatrix {
     Dtype s;
-    double c;
+    Rtype c;
 
     GivensMatrix dagger() {
         GivensMatrix res;
@@ -153,6 +154,62 @@ GivensMatrix<Dtype> diagonalize_2x2(const double mpp, const double mqq, const Dt
     return res;
 }
 
+/** @internal Branch-free version of diagonalize_2x2(), for the cyclic Jacobi routines.
+ * Can be instantiated with vector types R, the result is the unit matrix on lanes where
+ * skip is set.
+ */
+template <typename R, typename Dtype, typename Mask>
+GivensMatrix<Dtype, R> diagonalize_2x2_lanes(const R mpp, const R mqq, const Dtype mpq,
+                                            const Mask skip) {
+
+    GivensMatrix<Dtype, R> res;
+    R zero = 0, one = 1, two = 2;
+    R mpq2 = squarenorm(mpq);
+    R a = mqq - mpp;
+
+    // den == 0 only if mpq == 0 and mpp == mqq, no rotation then
+    R den = abs(a) + sqrt(a * a + 4.0 * mpq2);
+    R t = lane_select(den > zero, two / den, zero);
+    t = lane_select(a < zero, -t, t);
+
+    R c = one / sqrt(mpq2 * t * t + one);
+    res.c = lane_select(skip, one, c);
+    Dtype s = mpq * (t * res.c);
+    Dtype zs;
+    zs = 0;
+    res.s = lane_select(skip, zs, s);
+
+    return res;
+}
+
+/// @internal swap columns i and j of M on lanes where mask is set
+template <typename Mask, typename Mtype>
+inline void swap_columns_lanes(Mtype &M, int i, int j, const Mask &mask) {
+    for (int r = 0; r < M.rows(); r++) {
+        auto a = M.e(r, i);
+        M.e(r, i) = lane_select(mask, M.e(r, j), a);
+        M.e(r, j) = lane_select(mask, a, M.e(r, j));
+    }
+}
+
+/// @internal sort d lane by lane with odd-even transposition sort, and permute the columns
+/// of matrices mats accordingly.  Stable, like Matrix::sort()
+template <int n, typename R, typename... Mt>
+void sort_lanes(DiagonalMatrix<n, R> &d, enum hila::sort order, Mt &...mats) {
+    if (order == hila::sort::unsorted)
+        return;
+
+    for (int r = 0; r < n; r++) {
+        for (int i = r % 2; i < n - 1; i += 2) {
+            auto sw = (order == hila::sort::ascending) ? (d.e(i) > d.e(i + 1))
+                                                        : (d.e(i) < d.e(i + 1));
+            R t = d.e(i);
+            d.e(i) = lane_select(sw, d.e(i + 1), t);
+            d.e(i + 1) = lane_select(sw, t, d.e(i + 1));
+            (swap_columns_lanes(mats, i, i + 1, sw), ...);
+        }
+    }
+}
 
 } // namespace linalg
 } // namespace hila
@@ -589,6 +646,177 @@ svd_result<Mtype> Matrix_t<n, m, T, Mtype>::svd_pivot(enum hila::sort sorted) co
 }
 
 
+/**
+ * @brief Eigenvalues and -vectors of hermitean matrix with cyclic Jacobi sweeps
+ *
+ * Same interface as eigen_hermitean(), but the rotations are done in a fixed order,
+ * sweeping over all off-diagonal elements p < q, and the elements which are already
+ * negligible are skipped by masking the rotation to unity.  The only branch is the test
+ * whether all elements (on all vector lanes) have converged after a sweep.  Thus the
+ * function can be used in vectorized site loops, where hilapp instantiates it with AVX
+ * vector types.  Sorting is done with a fixed compare-and-swap network.
+ *
+ * The computation is done in the precision of the matrix elements.
+ *
+ * @return int  number of Jacobi sweeps
+ */
+template <int n, int m, typename T, typename Mtype>
+template <typename Et, typename Mt, typename MT>
+int Matrix_t<n, m, T, Mtype>::eigen_hermitean_cyclic(out_only DiagonalMatrix<n, Et> &E,
+                                                     out_only Matrix_t<n, n, Mt, MT> &U,
+                                                     enum hila::sort sorted) const {
+
+    static_assert(!hila::contains_complex<T>::value || hila::contains_complex<Mt>::value,
+                  "Eigenvector matrix must be complex with complex original matrix");
+
+    static_assert(n == m, "Eigensystem can be solved only for square matrices");
+
+    using R = hila::arithmetic_type<T>;
+    using Dtype = typename std::conditional<hila::contains_complex<T>::value, Complex<R>, R>::type;
+
+    constexpr double eps2 = sqr(fp<hila::lane_scalar_type<R>>::epsilon);
+    constexpr int max_sweeps = 50;
+
+    SquareMatrix<n, Dtype> M, V;
+    DiagonalMatrix<n, R> eigenvalues;
+
+    V = 1;
+    M = (*this);
+    eigenvalues = M.diagonal().real();
+
+    int sweep;
+    for (sweep = 1; sweep <= max_sweeps; sweep++) {
+
+        hila::lane_mask<R> converged = true;
+        for (int p = 0; p < n - 1; p++) {
+            for (int q = p + 1; q < n; q++) {
+
+                // lanes where the element is negligible are not rotated
+                auto small = ::squarenorm(M.e(p, q)) <=
+                             eps2 * ::abs(eigenvalues.e(p) * eigenvalues.e(q));
+                converged = converged & small;
+
+                auto P = hila::linalg::diagonalize_2x2_lanes(eigenvalues.e(p), eigenvalues.e(q),
+                                                             M.e(p, q), small);
+
+                P.dagger().mult_by_Givens_left(M, p, q);
+                P.mult_by_Givens_right(M, p, q);
+
+                eigenvalues.e(p) = ::real(M.e(p, p));
+                eigenvalues.e(q) = ::real(M.e(q, q));
+
+                M.e(p, q) = 0;
+                M.e(q, p) = 0;
+
+                P.mult_by_Givens_right(V, p, q);
+            }
+        }
+        if (hila::all_lanes(converged))
+            break;
+    }
+
+    hila::linalg::sort_lanes(eigenvalues, sorted, V);
+
+    E = eigenvalues;
+    U = V;
+
+    return (sweep > max_sweeps) ? max_sweeps : sweep;
+}
+
+template <int n, int m, typename T, typename Mtype>
+eigen_result<Mtype>
+Matrix_t<n, m, T, Mtype>::eigen_hermitean_cyclic(enum hila::sort sorted) const {
+
+    eigen_result<Mtype> res;
+    this->eigen_hermitean_cyclic(res.eigenvalues, res.eigenvectors, sorted);
+    return res;
+}
+
+/**
+ * @brief Singular value decomposition with cyclic one-sided Jacobi sweeps
+ *
+ * Same algorithm and interface as svd(), A = U S V*, but with the fixed rotation schedule
+ * and masked convergence of eigen_hermitean_cyclic(), so that it can be used in vectorized
+ * site loops.
+ *
+ * @return int  number of Jacobi sweeps
+ */
+template <int n, int m, typename T, typename Mtype>
+template <typename Et, typename Mt, typename MT>
+int Matrix_t<n, m, T, Mtype>::svd_cyclic(out_only Matrix_t<n, n, Mt, MT> &_U,
+                                         out_only DiagonalMatrix<n, Et> &_S,
+                                         out_only Matrix_t<n, n, Mt, MT> &_V,
+                                         enum hila::sort sorted) const {
+
+    static_assert(!hila::contains_complex<T>::value || hila::contains_complex<Mt>::value,
+                  "SVD: diagonalizing matrix must be complex with complex original matrix");
+
+    static_assert(n == m, "SVD can be solved only for square matrices");
+
+    using R = hila::arithmetic_type<T>;
+    using Dtype = typename std::conditional<hila::contains_complex<T>::value, Complex<R>, R>::type;
+
+    constexpr double eps2 = sqr(fp<hila::lane_scalar_type<R>>::epsilon);
+    constexpr int max_sweeps = 50;
+
+    SquareMatrix<n, Dtype> M, V;
+    DiagonalMatrix<n, R> S;
+
+    V = 1;
+    M = (*this);
+
+    int sweep;
+    for (sweep = 1; sweep <= max_sweeps; sweep++) {
+
+        hila::lane_mask<R> converged = true;
+        for (int p = 0; p < n - 1; p++) {
+            for (int q = p + 1; q < n; q++) {
+
+                auto colp = M.column(p);
+                auto colq = M.column(q);
+                R Bpp = colp.squarenorm();
+                R Bqq = colq.squarenorm();
+                Dtype Bpq = colp.dot(colq);
+
+                auto small = ::squarenorm(Bpq) <= eps2 * Bpp * Bqq;
+                converged = converged & small;
+
+                auto P = hila::linalg::diagonalize_2x2_lanes(Bpp, Bqq, Bpq, small);
+
+                // now do p,q rotation, only columns p,q change
+                P.mult_by_Givens_right(M, p, q);
+                P.mult_by_Givens_right(V, p, q);
+            }
+        }
+        if (hila::all_lanes(converged))
+            break;
+    }
+
+    // Now M = U S. Normalize columns
+    for (int i = 0; i < n; i++) {
+        auto col = M.column(i);
+        S.e(i) = col.norm();
+        M.set_column(i, col / S.e(i));
+    }
+
+    hila::linalg::sort_lanes(S, sorted, M, V);
+
+    _S = S;
+    _V = V;
+    _U = M;
+
+    return (sweep > max_sweeps) ? max_sweeps : sweep;
+}
+
+template <int n, int m, typename T, typename Mtype>
+svd_result<Mtype> Matrix_t<n, m, T, Mtype>::svd_cyclic(enum hila::sort sorted) const {
+
+    svd_result<Mtype> res;
+    this->svd_cyclic(res.U, res.singularvalues, res.V, sorted);
+    return res;
+}
+
+
 namespace hila {
 namespace linalg {
 
@@ -631,7 +859,6 @@ Rtype Minor(const Mtype &bigger, int row, int col) {
  * @return T result determinant
  */
 
-#pragma hila novector
 template <int n, int m, typename T, typename Mtype>
 T Matrix_t<n, m, T, Mtype>::det_laplace() const {
 
@@ -474,25 +474,28 @@ SU<N, T> chsexp(const Algebra<SU<N, T>> &a) {
 }
 
 
-// logarithm of SU(N) matrix with iterative Cayley-Hamilton
+// logarithm of SU(N) matrix with iterative Cayley-Hamilton.
+// Converged vector lanes are masked, so that this can be used in vectorized loops
 template <int N, typename T>
 Algebra<SU<N, T>> log(const SU<N, T> &a) {
     int maxit = 5 * N;
-    T fprec = fp<T>::epsilon * 10.0 * Algebra<SU<N, T>>::N_a;
+    T fprec = fp<hila::lane_scalar_type<T>>::epsilon * 10.0 * Algebra<SU<N, T>>::N_a;
     Matrix_t<N, N, Complex<T>, SU<N, T>> pl[N + 1];
 
     SU<N, T> tmat = a, tmat2;
     Algebra<SU<N, T>> res = 0, tres;
-    T trn, rn;
+    T trn, rn, zero = 0;
+    hila::lane_mask<T> done = false;
     int it, i;
     for (it = 0; it < maxit; ++it) {
         tres = tmat.project_to_algebra(trn);
         rn = 0;
         for (i = 0; i < Algebra<SU<N, T>>::N_a; ++i) {
-            res.e(i) += tres.e(i);
+            res.e(i) += hila::lane_select(done, zero, tres.e(i));
             rn += abs(res.e(i));
         }
-        if (trn < fprec * (rn + 1.0)) {
+        done = done | (trn < fprec * (rn + 1.0));
+        if (hila::all_lanes(done)) {
             break;
         }
         tmat = res.expand_scaled(-1.0);
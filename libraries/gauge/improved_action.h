@@ -5,6 +5,7 @@
 
 #include "hila.h"
 #include "gauge/wilson_line_and_force.h"
+#include "gauge/plaquette_measurements.h"
 
 /*
 * parameters for for different improved actions:
@@ -53,36 +54,9 @@ c12) {
 
 template <typename group, typename atype = hila::arithmetic_type<group>>
 atype measure_s_impr(const GaugeField<group> &U, atype c11, atype c12) {
-    // measure the improved action for dir1<dir2
-    Reduction<double> stot = 0;
-    stot.allreduce(false).delayed(true);
-    Field<group> tP;
-    foralldir(dir1) foralldir(dir2) if (dir1 < dir2) {
-        U[dir2].start_gather(dir1, ALL);
-        U[dir1].start_gather(dir2, ALL);
-        onsites(ALL) {
-            // plaquettes:
-            tP[X] = U[dir1][X] * U[dir2][X + dir1] * (U[dir2][X] * U[dir1][X + dir2]).dagger();
-
-            // plaquette part:
-            stot += c11 * (1.0 - real(trace(tP[X])) / group::size());
-        }
-
-        tP.start_gather(dir1, ALL);
-        tP.start_gather(dir2, ALL);
-
-        onsites(ALL) {
-            // 2x1-rectangle part:
-            stot +=
-                c12 * (1.0 - real(trace(U[dir1][X] * tP[X + dir1] * U[dir1][X].dagger() * tP[X])) /
-                                 group::size());
-            // 1x2-rectangle part:
-            stot +=
-                c12 * (1.0 - real(trace(tP[X] * U[dir2][X] * tP[X + dir2] * U[dir2][X].dagger())) /
-                                 group::size());
-        }
-    }
-    return (atype)stot.value();
+    // measure the improved action for dir1<dir2, plaquettes and rectangles
+    plaquette_sums ps = measure_plaquettes(U, true);
+    return (atype)(c11 * ps.total() + c12 * ps.rect_total());
 }
 
 template <typename group, typename atype = hila::arithmetic_type<group>>
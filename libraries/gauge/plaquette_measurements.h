@@ -0,0 +1,146 @@
+/** @file plaquette_measurements.h */
+
+#ifndef PLAQUETTE_MEASUREMENTS_H_
+#define PLAQUETTE_MEASUREMENTS_H_
+
+#include "hila.h"
+
+// Fused measurement of plaquettes of all orientations, and optionally rectangles.
+// All plaquette orientations are computed in a single site loop, reading the links
+// and their forward neighbours once, instead of one loop and a set of gathers per
+// orientation.  The orientations are written out explicitly, because inside site loops
+// the Field array index U[d] cannot be a loop variable.
+
+static_assert(NDIM >= 2 && NDIM <= 4, "plaquette measurements need 2 <= NDIM <= 4");
+
+/**
+ * @brief Plaquette and rectangle sums from measure_plaquettes()
+ * @details plaq[d1][d2], d1 < d2, is the sum over the lattice of 1 - ReTr P_{d1 d2}(X) / N.
+ * rect[d1][d2] is the same for the 2x1 and 1x2 rectangles in the d1-d2 plane, summed.
+ * The last direction is taken as time in spatial() and temporal().
+ * As in measure_s_wplaq(), the values are valid on rank 0.
+ */
+struct plaquette_sums {
+    double plaq[NDIM][NDIM] = {};
+    double rect[NDIM][NDIM] = {};
+
+    /// sum over all orientations
+    double total() const {
+        double s = 0;
+        foralldir(d1) foralldir(d2) if (d1 < d2) s += plaq[d1][d2];
+        return s;
+    }
+
+    /// sum over orientations in the spatial directions
+    double spatial() const {
+        double s = 0;
+        foralldir(d1) foralldir(d2) if (d1 < d2 && d2 < NDIM - 1) s += plaq[d1][d2];
+        return s;
+    }
+
+    /// sum over orientations with one temporal direction
+    double temporal() const {
+        double s = 0;
+        foralldir(d1) if (d1 < NDIM - 1) s += plaq[d1][NDIM - 1];
+        return s;
+    }
+
+    /// sum of rectangles over all orientations
+    double rect_total() const {
+        double s = 0;
+        foralldir(d1) foralldir(d2) if (d1 < d2) s += rect[d1][d2];
+        return s;
+    }
+};
+
+// number of plaquette orientations
+constexpr int n_plaq_orientations = NDIM * (NDIM - 1) / 2;
+
+// index of orientation d1 < d2 in the plaquette arrays
+inline constexpr int plaq_index(int d1, int d2) {
+    return d2 * (d2 - 1) / 2 + d1;
+}
+
+// 1 - ReTr(a b (d c)^+) / N, plaquette with a = U_1(X), b = U_2(X+1), c = U_1(X+2), d = U_2(X)
+template <typename group>
+inline double plaq_density(const group &a, const group &b, const group &c, const group &d) {
+    return 1.0 - real(trace(a * b * (d * c).dagger())) / group::size();
+}
+
+template <typename group>
+inline group plaq_matrix(const group &a, const group &b, const group &c, const group &d) {
+    return a * b * (d * c).dagger();
+}
+
+/**
+ * @brief Measure plaquettes of all orientations, and optionally rectangles
+ * @details Plaquettes are summed in one site loop.  With rectangles = true each orientation
+ * in turn stores its plaquette matrices in a single temporary field, and the rectangles are
+ * summed using the neighbouring plaquettes, as in measure_s_impr().
+ *
+ *   plaquette_sums ps = measure_plaquettes(U);
+ *   double plaq = ps.total() / (lattice.volume() * NDIM * (NDIM - 1) / 2);
+ */
+template <typename group>
+plaquette_sums measure_plaquettes(const GaugeField<group> &U, bool rectangles = false) {
+
+    // all forward neighbours needed, gathered once
+    foralldir(d1) foralldir(d2) if (d1 != d2) U[d1].start_gather(d2, ALL);
+
+    plaquette_sums res;
+
+    if (!rectangles) {
+        // Reduction of a Vector type, not a ReductionVector: ReductionVector elements
+        // are not thread private in OpenMP loops, and limit the GPU thread blocks
+        Reduction<Vector<n_plaq_orientations, double>> pl;
+        pl.allreduce(false);
+
+        // orientation index plaq_index(d1, d2):
+        //   0: x-y, 1: x-z, 2: y-z, 3: x-t, 4: y-t, 5: z-t
+        onsites(ALL) {
+            Vector<n_plaq_orientations, double> p;
+            p[0] = plaq_density(U[e_x][X], U[e_y][X + e_x], U[e_x][X + e_y], U[e_y][X]);
+#if NDIM > 2
+            p[1] = plaq_density(U[e_x][X], U[e_z][X + e_x], U[e_x][X + e_z], U[e_z][X]);
+            p[2] = plaq_density(U[e_y][X], U[e_z][X + e_y], U[e_y][X + e_z], U[e_z][X]);
+#endif
+#if NDIM > 3
+            p[3] = plaq_density(U[e_x][X], U[e_t][X + e_x], U[e_x][X + e_t], U[e_t][X]);
+            p[4] = plaq_density(U[e_y][X], U[e_t][X + e_y], U[e_y][X + e_t], U[e_t][X]);
+            p[5] = plaq_density(U[e_z][X], U[e_t][X + e_z], U[e_z][X + e_t], U[e_t][X]);
+#endif
+            pl += p;
+        }
+
+        Vector<n_plaq_orientations, double> pv = pl.value();
+        foralldir(d1) foralldir(d2) if (d1 < d2) res.plaq[d1][d2] = pv[plaq_index(d1, d2)];
+
+    } else {
+        // one plaquette field, reused for each orientation
+        Field<group> P;
+
+        // plaquette, and 2x1 and 1x2 rectangles U_1(X) P(X+1) U_1(X)^+ P(X) and
+        // P(X) U_2(X) P(X+2) U_2(X)^+
+        foralldir(d1) foralldir(d2) if (d1 < d2) {
+            Reduction<double> pl, rc;
+            pl.allreduce(false);
+            rc.allreduce(false);
+
+            onsites(ALL) {
+                P[X] = plaq_matrix(U[d1][X], U[d2][X + d1], U[d1][X + d2], U[d2][X]);
+                pl += 1.0 - real(trace(P[X])) / group::size();
+            }
+            onsites(ALL) {
+                rc += 2.0 - real(trace(U[d1][X] * P[X + d1] * U[d1][X].dagger() * P[X]) +
+                                 trace(P[X] * U[d2][X] * P[X + d2] * U[d2][X].dagger())) /
+                                group::size();
+            }
+            res.plaq[d1][d2] = pl.value();
+            res.rect[d1][d2] = rc.value();
+        }
+    }
+
+    return res;
+}
+
+#endif
@@ -7,7 +7,8 @@
 
 /**
  * @brief Measure Polyakov lines to direction dir
- * @details Naive implementation, includes extra communication
+ * @details Naive implementation, includes extra communication.  On CPU targets the
+ * plane loops visit only the sites of the plane (SiteRegion)
  * @tparam T GaugeField Group
  * @param U GaugeField to measure
  * @param dir Direction
@@ -18,6 +19,14 @@ Complex<double> measure_polyakov(const GaugeField<T> &U, Direction dir = Directi
 
     Field<T> polyakov = U[dir];
 
+#if !(defined(CUDA) || defined(HIP))
+    // plane regions, built once for all planes
+    std::vector<SiteRegion> planes;
+    planes.reserve(lattice.size(dir));
+    for (int plane = 0; plane < lattice.size(dir); plane++)
+        planes.push_back(SiteRegion::plane(dir, plane));
+#endif
+
     // mult links so that polyakov[X.dir == 0] contains the polyakov loop
     for (int plane = lattice.size(dir) - 2; plane >= 0; plane--) {
 
@@ -26,19 +35,32 @@ Complex<double> measure_polyakov(const GaugeField<T> &U, Direction dir = Directi
         // site on different "iterations" of the loop.  However, here this
         // is restricted on single dir-plane so it works but we must tell it to hilapp.
 
+#if !(defined(CUDA) || defined(HIP))
+#pragma hila safe_access(polyakov)
+        onsites(planes[plane]) {
+            polyakov[X] = U[dir][X] * polyakov[X + dir];
+        }
+#else
 #pragma hila safe_access(polyakov)
         onsites(ALL) {
             if (X.coordinate(dir) == plane) {
                 polyakov[X] = U[dir][X] * polyakov[X + dir];
             }
         }
+#endif
     }
 
     Complex<double> ploop = 0;
 
+#if !(defined(CUDA) || defined(HIP))
+    onsites(planes[0]) {
+        ploop += trace(polyakov[X]);
+    }
+#else
     onsites(ALL) if (X.coordinate(dir) == 0) {
         ploop += trace(polyakov[X]);
     }
+#endif
 
     // return average polyakov
     return ploop / (lattice.volume() / lattice.size(dir));
@@ -28,6 +28,8 @@ template <typename T>
 void staplesum(const GaugeField<T> &U, Field<T> &staples, Direction d1, Parity par = ALL) {
 
     Field<T> lower;
+    // lower is gathered over the boundary like U[d1], needed for twisted b.c.
+    lower.copy_boundary_condition(U[d1]);
 
     bool first = true;
     foralldir(d2) if (d2 != d1) {
@@ -100,42 +100,62 @@ void suN_overrelax(SU<N, T> &U, const SU<N, T> &staple) {
 
 #define USE_deForcrandJahn
 
-template <typename T, int N, typename Btype>
-int suN_overrelax_dFJ(SU<N, T> &U, const SU<N, T> &S, Btype beta) {
+/**
+ * @brief Overrelaxation candidate Z U.dagger() Z of suN_overrelax_dFJ(), without accept/reject
+ *
+ * The index of the smallest singular value is not needed in the Sherman-Morrison solution:
+ * with r_j = tan(phi/N) (D_j - D_min) (r_min = 0),
+ *     theta_j = (r_j - c sum_k r_k / D_k) / D_j,   c = D_min / (1 + D_min sum_k 1 / D_k),
+ * sums over k != min, and theta_min = -sum_j theta_j.  Together with the branch-free
+ * svd_cyclic() the function contains no data dependent branches or random numbers, so that
+ * a site loop computing the candidates can be vectorized.  For N >= 5 the determinant is
+ * computed with LU decomposition, as in det(), and the loop is not vectorized.
+ */
+template <typename T, int N>
+SU<N, T> suN_overrelax_dFJ_candidate(const SU<N, T> &U, const SU<N, T> &S) {
 
-    auto svdS = S.svd();
-    auto phiN = S.det().arg() / N;
+    auto svdS = S.svd_cyclic();
+    // Laplace expansion is branch-free but O(N!); det() switches to LU (not vectorizable)
+    // at N >= 5, where the cost would dominate
+    T phiN;
+    if constexpr (N < 5)
+        phiN = S.det_laplace().arg() / N;
+    else
+        phiN = S.det().arg() / N;
 
 #ifdef USE_deForcrandJahn
-    // find smallest singular value
-    int imin = 0;
-    double smin = svdS.singularvalues.e(0);
-    for (int i = 1; i < N; i++) {
-        if (svdS.singularvalues.e(i) < smin) {
-            smin = svdS.singularvalues.e(i);
-            imin = i;
-        }
-    }
+    const auto &D = svdS.singularvalues;
 
-    DiagonalMatrix<N - 1, double> diag;
-    int j = 0;
+    // mark the (first) smallest singular value
+    T smin = D.e(0);
+    for (int i = 1; i < N; i++)
+        smin = hila::lane_select(D.e(i) < smin, D.e(i), smin);
+
+    hila::lane_mask<T> is_min[N], found = false;
     for (int i = 0; i < N; i++) {
-        if (i != imin)
-            diag.e(j++) = svdS.singularvalues.e(i);
+        is_min[i] = (D.e(i) == smin) & !found;
+        found = found | is_min[i];
     }
 
-    // Do the Sherman-Morrison inverse - diag will contain the phase angles
-    diag.asVector() = hila::linalg::invert_diagonal_plus_constant_matrix(diag, smin) *
-           (tan(phiN) * (diag - smin).asVector());
+    T zero = 0, one = 1, tphi = tan(phiN), sum_inv = 0, sum_rd = 0;
+    for (int i = 0; i < N; i++) {
+        T inv = hila::lane_select(is_min[i], zero, one / D.e(i));
+        sum_inv += inv;
+        sum_rd += tphi * (D.e(i) - smin) * inv;
+    }
+    T c = smin / (1.0 + smin * sum_inv);
 
-    // and construct diagonal P - absorb e^{-i phi/N} to P
-    DiagonalMatrix<N, Complex<T>> P;
-    j = 0;
+    // phase angles, and construct diagonal P - absorb e^{-i phi/N} to P
+    T theta[N], theta_sum = 0;
     for (int i = 0; i < N; i++) {
-        if (i != imin)
-            P.e(i) = expi(diag.e(j++) - phiN);
+        T t = (tphi * (D.e(i) - smin) - c * sum_rd) / D.e(i);
+        theta[i] = hila::lane_select(is_min[i], zero, t);
+        theta_sum += theta[i];
     }
-    P.e(imin) = expi(-trace(diag) - phiN);
+
+    DiagonalMatrix<N, Complex<T>> P;
+    for (int i = 0; i < N; i++)
+        P.e(i) = expi(hila::lane_select(is_min[i], -theta_sum, theta[i]) - phiN);
 #else
     // This is Narayanan-Neuberger method.  It has slightly worse acceptance
     // to Forcrand + Jahn
@@ -144,10 +164,142 @@ int suN_overrelax_dFJ(SU<N, T> &U, const SU<N, T> &S, Btype beta) {
 #endif
 
     // make unitary matrix Z
-    auto Z = svdS.U * P * svdS.V.dagger();
+    SU<N, T> Z = svdS.U * P * svdS.V.dagger();
+
+    // candidate for new U
+    return Z * U.dagger() * Z;
+}
+
+/**
+ * @brief Accept or reject overrelaxation candidate Z with the change in action
+ * @return 1 if accepted (U is set to Z), 0 otherwise
+ */
+template <typename T, int N, typename Btype>
+int suN_overrelax_accept(SU<N, T> &U, const SU<N, T> &Z, const SU<N, T> &S, Btype beta) {
+
+    // exp(old-new) > random()
+    if (exp(beta / N * real(mul_trace(Z - U, S.dagger()))) > hila::random()) {
+        // accepted
+        U = Z;
+        return 1;
+    } else
+        return 0;
+}
+
+/**
+ * @brief \f$ SU(N) \f$ full overrelaxation using SVD, see above
+ *
+ * This function contains the random number for the accept/reject step, which prevents
+ * vectorization of the site loop.  For vectorized updates compute the candidates
+ * separately:
+ *
+ *   onsites(par) Z[X] = suN_overrelax_dFJ_candidate(U[d][X], S[X]);
+ *   onsites(par) acc += suN_overrelax_accept(U[d][X], Z[X], S[X], beta);
+ *
+ * @return 1 if accepted, 0 otherwise
+ */
+template <typename T, int N, typename Btype>
+int suN_overrelax_dFJ(SU<N, T> &U, const SU<N, T> &S, Btype beta) {
+
+    return suN_overrelax_accept(U, suN_overrelax_dFJ_candidate(U, S), S, beta);
+}
+
+
+/**
+ * @internal Invert square matrix with Gauss-Jordan elimination and partial pivoting.
+ * Returns false if the matrix is singular.
+ */
+#pragma hila novector
+template <int N, typename T>
+bool suN_invert_gauss_jordan(SquareMatrix<N, Complex<T>> &A,
+                             out_only SquareMatrix<N, Complex<T>> &inv) {
+    inv = 1;
+    for (int j = 0; j < N; j++) {
+        // pivot row
+        int ip = j;
+        T big = ::squarenorm(A.e(j, j));
+        for (int i = j + 1; i < N; i++) {
+            T t = ::squarenorm(A.e(i, j));
+            if (t > big) {
+                big = t;
+                ip = i;
+            }
+        }
+        if (big == 0)
+            return false;
+        if (ip != j) {
+            for (int k = 0; k < N; k++) {
+                hila::swap(A.e(ip, k), A.e(j, k));
+                hila::swap(inv.e(ip, k), inv.e(j, k));
+            }
+        }
+        Complex<T> p = 1 / A.e(j, j);
+        for (int k = 0; k < N; k++) {
+            A.e(j, k) *= p;
+            inv.e(j, k) *= p;
+        }
+        for (int i = 0; i < N; i++) {
+            if (i != j) {
+                Complex<T> f = A.e(i, j);
+                for (int k = 0; k < N; k++) {
+                    A.e(i, k) -= f * A.e(j, k);
+                    inv.e(i, k) -= f * inv.e(j, k);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief \f$ SU(N) \f$ full overrelaxation using polar decomposition, without SVD
+ *
+ * Same update as suN_overrelax_dFJ, but the unitary matrix which maximizes
+ * ReTr(Z S.dagger()) is found with the scaled Newton iteration for the polar decomposition
+ * (Higham):
+ *     X_0 = S,   X_{k+1} = (z_k X_k + (z_k X_k)^{-1}.dagger()) / 2,
+ *     z_k = (|X_k^{-1}| / |X_k|)^{1/2}  (Frobenius norms)
+ * which converges quadratically to the unitary factor W of S = W H.  Typically 5-8
+ * iterations, each one matrix inversion.
+ *
+ * The determinant is fixed with the phase of det S, Z = e^{-i phi/N} W (Narayanan-Neuberger),
+ * which has slightly lower acceptance than the dFJ optimized phases.  The proposal
+ * U_new = Z U_old.dagger() Z is accepted/rejected with the change in action, as in dFJ.
+ *
+ * @return 1 if accepted, 0 otherwise
+ */
+
+template <typename T, int N, typename Btype>
+int suN_overrelax_polar(SU<N, T> &U, const SU<N, T> &S, Btype beta) {
+
+    constexpr int max_iter = 20;
+    // diff is the squared norm of the step: stop when the step is below sqrt(N eps).
+    // The convergence is quadratic, so the new X is then accurate to ~N eps
+    const T tol = N * std::numeric_limits<T>::epsilon();
+
+    SquareMatrix<N, Complex<T>> X, Xi, A;
+    X = S;
+    int iter;
+    for (iter = 0; iter < max_iter; iter++) {
+        A = X;
+        if (!suN_invert_gauss_jordan(A, Xi))
+            return 0; // singular staple, no update
+
+        // scaling factor, not needed when close to convergence
+        T zeta = sqrt(sqrt(Xi.squarenorm() / X.squarenorm()));
+        A = 0.5 * (zeta * X + Xi.dagger() / zeta);
+
+        T diff = (A - X).squarenorm();
+        X = A;
+        if (diff < tol)
+            break;
+    }
+
+    auto phiN = S.det().arg() / N;
+    X *= expi(-phiN);
 
     // candidate for new U
-    Z = Z * U.dagger() * Z;
+    SU<N, T> Z = X * U.dagger() * X;
 
     // exp(old-new) > random()
     if (exp(beta / N * real(mul_trace(Z - U, S.dagger()))) > hila::random()) {
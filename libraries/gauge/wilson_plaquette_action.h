@@ -4,6 +4,7 @@
 #define WILSON_PLAQUETTE_ACTION_H_
 
 #include "hila.h"
+#include "gauge/plaquette_measurements.h"
 
 // functions for Wilson's plaquette action -S_{impr}=\beta/N * \sum_{plaq} ReTr(plaq)
 
@@ -42,19 +43,8 @@ void rstaplesum(const GaugeField<T> &U, Field<T> &staples, Direction d1, Parity
 
 template <typename group, typename atype = hila::arithmetic_type<group>>
 atype measure_s_wplaq(const GaugeField<group> &U) {
-    // measure the Wilson plaquette action
-    Reduction<double> plaq = 0;
-    plaq.allreduce(false).delayed(true);
-    foralldir(dir1) foralldir(dir2) if (dir1 < dir2) {
-        U[dir2].start_gather(dir1, ALL);
-        U[dir1].start_gather(dir2, ALL);
-        onsites(ALL) {
-            plaq += 1.0 - real(trace(U[dir1][X] * U[dir2][X + dir1] *
-                                     (U[dir2][X] * U[dir1][X + dir2]).dagger())) /
-                              group::size();
-        }
-    }
-    return (atype)plaq.value();
+    // measure the Wilson plaquette action, all orientations in one site loop
+    return (atype)measure_plaquettes(U).total();
 }
 
 template <typename group, typename atype = hila::arithmetic_type<group>>
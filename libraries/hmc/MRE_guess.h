@@ -8,7 +8,7 @@
 /// Builds an initial guess for a matrix inverter given a set of basis vectors
 template <typename vector_type, typename DIRAC_OP>
 void MRE_guess(Field<vector_type> &psi, Field<vector_type> &chi, DIRAC_OP D,
-               std::vector<Field<vector_type>> old_chi_inv) {
+               const std::vector<Field<vector_type>> &old_chi_inv) {
     int MRE_size = old_chi_inv.size();
     double M[MRE_size][MRE_size];
     double v[MRE_size];
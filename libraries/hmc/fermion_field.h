@@ -131,13 +131,15 @@ class fermion_action : public action_base {
         D.dagger(psi, chi);
     }
 
-    /// Add new solution to the list for MRE
+    /// Add new solution to the list for MRE. The list is a ring of buffers
+    /// rotated by swapping: psi is swapped in as the newest solution, and
+    /// gets the buffer of the oldest one.
     void save_new_solution(Field<vector_type> &psi) {
         if (MRE_size > 0) {
-            for (int i = 1; i < MRE_size; i++) {
-                old_chi_inv[i] = old_chi_inv[i - 1];
+            for (int i = MRE_size - 1; i > 0; i--) {
+                hila::swap(old_chi_inv[i], old_chi_inv[i - 1]);
             }
-            old_chi_inv[0] = psi;
+            hila::swap(old_chi_inv[0], psi);
         }
     }
 
@@ -155,7 +157,6 @@ class fermion_action : public action_base {
         hila::out0 << "base force\n";
         initial_guess(chi, psi);
         inverse.apply(chi, psi);
-        save_new_solution(psi);
 
         D.apply(psi, Mpsi);
 
@@ -163,7 +164,12 @@ class fermion_action : public action_base {
         D.force(psi, Mpsi, force2, -1);
 
         foralldir(dir) { force[dir][ALL] = -eps * (force[dir][X] + force2[dir][X]); }
+        if (measuring_force)
+            force_norm2 = force_norm_squared(force, eps);
         gauge.add_momentum(force);
+
+        // psi is not needed after this, swap it into the MRE history
+        save_new_solution(psi);
     }
 };
 
@@ -197,6 +203,8 @@ class Hasenbusch_action_1 : public action_base {
     void action(Field<double> &S) { base_action.action(S); }
     void draw_gaussian_fields() { base_action.draw_gaussian_fields(); }
     void force_step(double eps) { base_action.force_step(eps); }
+    void measure_force(bool on) { base_action.measure_force(on); }
+    double last_force_norm2() { return base_action.last_force_norm2(); }
 };
 
 /// The second Hasenbusch action term, D_h2 = D/(D^dagger + mh).
@@ -334,13 +342,15 @@ class Hasenbusch_action_2 : public action_base {
         }
     }
 
-    /// Add new solution to the list
+    /// Add new solution to the list. The list is a ring of buffers
+    /// rotated by swapping: psi is swapped in as the newest solution, and
+    /// gets the buffer of the oldest one.
     void save_new_solution(Field<vector_type> &psi) {
         if (MRE_size > 0) {
-            for (int i = 1; i < MRE_size; i++) {
-                old_chi_inv[i] = old_chi_inv[i - 1];
+            for (int i = MRE_size - 1; i > 0; i--) {
+                hila::swap(old_chi_inv[i], old_chi_inv[i - 1]);
             }
-            old_chi_inv[0] = psi;
+            hila::swap(old_chi_inv[0], psi);
         }
     }
 
@@ -361,7 +371,6 @@ class Hasenbusch_action_2 : public action_base {
 
         initial_guess(Dhchi, psi);
         inverse.apply(Dhchi, psi);
-        save_new_solution(psi);
 
         D.apply(psi, Mpsi);
 
@@ -371,7 +380,12 @@ class Hasenbusch_action_2 : public action_base {
         D.force(psi, Mpsi, force2, -1);
 
         foralldir(dir) { force[dir][ALL] = -eps * (force[dir][X] + force2[dir][X]); }
+        if (measuring_force)
+            force_norm2 = force_norm_squared(force, eps);
         gauge.add_momentum(force);
+
+        // psi is not needed after this, swap it into the MRE history
+        save_new_solution(psi);
     }
 };
 
@@ -0,0 +1,148 @@
+#ifndef FOURIER_ACCELERATION_H
+#define FOURIER_ACCELERATION_H
+
+#include "hila.h"
+#include "integrator.h"
+
+/// Fourier accelerated momentum action of a scalar field.
+///
+/// The kinetic term has a mode dependent mass,
+///   T = 1/2 sum_k |pi(k)|^2 / M(k),   M(k) = (khat^2 + m^2) / (4 NDIM + m^2),
+/// where khat^2 = sum_d 4 sin^2(k_d/2) and m is the acceleration mass.
+/// For the free field with mass m all modes then evolve with the same frequency,
+/// which equals that of the fastest mode without acceleration, so that the MD
+/// step size is unchanged but long wavelength modes are updated as fast as
+/// short ones.  The momentum draw and the field update are done in k-space
+/// with FFT_field().  With m <= 0 the mass is 1 for all modes and no FFTs are
+/// done.
+///
+/// Like gauge_momentum_action, this is the lowest level of an integrator:
+///
+///   Field<double> phi;
+///   fourier_momentum_action<double> ma(phi, mass);
+///   my_scalar_action sa(phi, ma.momentum, ...);   // force_step: momentum -= eps dS/dphi
+///   O2_integrator integrator(sa, ma);
+///   update_hmc(integrator, steps, traj_length);
+///
+/// The field element type must be real (float, double) or contain complex
+/// numbers.
+template <typename T>
+class fourier_momentum_action : public action_base, public integrator_base {
+  public:
+    static_assert(std::is_floating_point<T>::value || hila::contains_complex<T>::value,
+                  "fourier_momentum_action requires real or complex field type");
+
+    /// The complex type used in the transforms
+    using ctype = std::conditional_t<std::is_floating_point<T>::value, Complex<T>, T>;
+
+    /// A reference to the scalar field
+    Field<T> &phi;
+    /// The canonical momentum of phi
+    Field<T> momentum;
+    /// Copy of phi in case the trajectory is rejected
+    Field<T> phi_backup;
+
+    /// The acceleration mass m
+    double acc_mass;
+    /// sqrt(M(k)) and 1/M(k)
+    Field<double> mass_sqrt, mass_inv;
+
+    /// construct from a field and the acceleration mass
+    fourier_momentum_action(Field<T> &f, double m) : phi(f) {
+        set_acceleration_mass(m);
+    }
+    /// No copies: the scalar action refers to the momentum of this object, a copy would
+    /// step a momentum the force is not applied to
+    fourier_momentum_action(const fourier_momentum_action &) = delete;
+
+    /// Set the acceleration mass, m <= 0 turns acceleration off
+    void set_acceleration_mass(double m) {
+        acc_mass = m;
+        if (m <= 0)
+            return;
+        double norm = 4 * NDIM + m * m;
+        onsites(ALL) {
+            auto k = X.coordinates().convert_to_k();
+            double k2 = 0;
+            foralldir(d) {
+                double s = sin(0.5 * k[d]);
+                k2 += 4 * s * s;
+            }
+            double M = (k2 + m * m) / norm;
+            mass_sqrt[X] = sqrt(M);
+            mass_inv[X] = 1.0 / M;
+        }
+    }
+
+    bool accelerated() const {
+        return acc_mass > 0;
+    }
+
+    /// Fourier transform of src, as a complex field
+    void to_k_space(const Field<T> &src, Field<ctype> &res) const {
+        if constexpr (std::is_floating_point<T>::value) {
+            onsites(ALL) res[X] = Complex<T>(src[X], 0);
+        } else {
+            res = src;
+        }
+        FFT_field(res, res);
+    }
+
+    /// res = FFT^-1 w(k) FFT src, with the 1/V normalization
+    void apply_mode_weight(const Field<T> &src, const Field<double> &w, Field<T> &res) const {
+        Field<ctype> c;
+        to_k_space(src, c);
+        double inv_vol = 1.0 / lattice.volume();
+        onsites(ALL) c[X] *= w[X] * inv_vol;
+        FFT_field(c, c, fft_direction::back);
+        if constexpr (std::is_floating_point<T>::value) {
+            onsites(ALL) res[X] = c[X].re;
+        } else {
+            res = c;
+        }
+    }
+
+    /// The kinetic action
+    double action() {
+        double Sa = 0;
+        if (accelerated()) {
+            Field<ctype> c;
+            to_k_space(momentum, c);
+            onsites(ALL) Sa += squarenorm(c[X]) * mass_inv[X];
+            Sa /= lattice.volume();
+        } else {
+            onsites(ALL) Sa += squarenorm(momentum[X]);
+        }
+        return 0.5 * Sa;
+    }
+
+    /// Gaussian random momentum with covariance M(k)
+    void draw_gaussian_fields() {
+        momentum.gaussian_random();
+        if (accelerated())
+            apply_mode_weight(momentum, mass_sqrt, momentum);
+    }
+
+    /// Make a copy of fields updated in a trajectory
+    void backup_fields() {
+        phi_backup = phi;
+    }
+
+    /// Restore the previous backup
+    void restore_backup() {
+        phi = phi_backup;
+    }
+
+    /// Update the field with momentum, dphi/dt = M^-1 pi
+    void step(double eps) {
+        if (accelerated()) {
+            Field<T> v;
+            apply_mode_weight(momentum, mass_inv, v);
+            phi[ALL] = phi[X] + eps * v[X];
+        } else {
+            phi[ALL] = phi[X] + eps * momentum[X];
+        }
+    }
+};
+
+#endif
@@ -2,7 +2,7 @@
 #define GAUGE_FIELD_H
 
 #include "hila.h"
-#include "datatypes/sun.h"
+#include "datatypes/sun_matrix.h"
 #include "datatypes/representations.h"
 #include "integrator.h"
 
@@ -17,13 +17,22 @@ template <typename sun> class gauge_field_base {
     /// The size of the matrix
     static constexpr int N = sun::size;
 
-    /// A matrix field for each Direction
+    /// A matrix field for each Direction.  Read it directly, but modify it only
+    /// through the methods of the gauge field class, which keep the HMC backup
+    /// and the version below consistent
     Field<sun> gauge[NDIM];
     /// Also create a momentum field. This is only
     /// allocated if necessary
     Field<sun> momentum[NDIM];
 
-    /// Recalculate represented or smeared field
+    /// Version of the gauge field, incremented whenever the field changes.
+    /// Represented and smeared fields compare this to the version they were
+    /// computed from, and recalculate only if it has changed.
+    int64_t version = 0;
+    /// Mark the gauge field changed.  Called by the methods that modify gauge[]
+    void mark_changed() { version++; }
+
+    /// Recalculate represented or smeared field, if the underlying field has changed
     virtual void refresh() {}
     /// Set the field to unity
     virtual void set_unity() {}
@@ -36,7 +45,7 @@ template <typename sun> class gauge_field_base {
     virtual void draw_momentum() {}
     /// Set the momentum to zero
     virtual void zero_momentum() {}
-    /// Make a copy of the gauge field for HMC
+    /// Save the gauge field for HMC
     virtual void backup() {}
     /// Restore the gauge field from the backup.
     /// Used when an HMC trajectory is rejected.
@@ -55,13 +64,22 @@ template <template <int, typename> class M, int N> class gauge_field_base<M<N, d
     /// The matrix type
     using gauge_type = M<N, double>;
 
-    /// A matrix field for each Direction
+    /// A matrix field for each Direction.  Read it directly, but modify it only
+    /// through the methods of the gauge field class, which keep the HMC backup
+    /// and the version below consistent
     Field<gauge_type> gauge[NDIM];
     /// Also create a momentum field. This is only
     /// allocated if necessary
     Field<gauge_type> momentum[NDIM];
 
-    /// Recalculate represented or smeared field
+    /// Version of the gauge field, incremented whenever the field changes.
+    /// Represented and smeared fields compare this to the version they were
+    /// computed from, and recalculate only if it has changed.
+    int64_t version = 0;
+    /// Mark the gauge field changed.  Called by the methods that modify gauge[]
+    void mark_changed() { version++; }
+
+    /// Recalculate represented or smeared field, if the underlying field has changed
     virtual void refresh() {}
     /// Set the field to unity
     virtual void set_unity() {}
@@ -74,7 +92,7 @@ template <template <int, typename> class M, int N> class gauge_field_base<M<N, d
     virtual void draw_momentum() {}
     /// Set the momentum to zero
     virtual void zero_momentum() {}
-    /// Make a copy of the gauge field for HMC
+    /// Save the gauge field for HMC
     virtual void backup() {}
     /// Restore the gauge field from the backup.
     /// Used when an HMC trajectory is rejected.
@@ -201,23 +219,47 @@ template <typename matrix> class gauge_field : public gauge_field_base<matrix> {
     using basetype = hila::arithmetic_type<matrix>;
     /// The size of the matrix
     static constexpr int N = matrix::size;
-    /// Storage for a backup of the gauge field
+    /// Storage for a backup of the gauge field.
+    /// backup() does not copy the field, it only records the version of the
+    /// current field: until the next update the backup is gauge[] itself.
+    /// The first gauge_update() after backup() writes the updated field into
+    /// gauge_backup and swaps the two, after which gauge_backup holds the saved
+    /// field. Rejecting a trajectory then swaps them back, and accepting does
+    /// nothing, so neither copies the field.
+    /// This relies on gauge[] being modified only by the methods below:
+    /// modify_gauge() and the other in-place modifiers copy the backup out first.
     Field<matrix> gauge_backup[NDIM];
+    /// Version of the field saved by backup(), -1 if there is none
+    int64_t backup_version = -1;
+    /// True while the backup is the current field in gauge[]
+    bool backup_in_gauge = false;
+
+    /// Copy the backup out of gauge[] before gauge[] is modified in place
+    void detach_backup() {
+        if (backup_in_gauge) {
+            foralldir(dir) gauge_backup[dir] = this->gauge[dir];
+            backup_in_gauge = false;
+        }
+    }
 
     /// Set the gauge field to unity
     void set_unity() {
+        detach_backup();
         foralldir(dir) {
             onsites(ALL) { this->gauge[dir][X] = 1; }
         }
+        this->mark_changed();
     }
 
     /// Draw a random gauge field
     void random() {
+        detach_backup();
         foralldir(dir) {
             onsites(ALL) {
                 this->gauge[dir][X].random();
             }
         }
+        this->mark_changed();
     }
 
     /// Gaussian random momentum for each element
@@ -234,20 +276,44 @@ template <typename matrix> class gauge_field : public gauge_field_base<matrix> {
         foralldir(dir) { this->momentum[dir][ALL] = 0; }
     }
 
-    /// Update the gauge field with time step eps
+    /// Update the gauge field with time step eps.  The directions are updated
+    /// as independent OpenMP tasks
     void gauge_update(double eps) {
-        foralldir(dir) {
-            onsites(ALL) {
-                element<matrix> momexp = (eps * this->momentum[dir][X]).exp();
-                this->gauge[dir][X] = momexp * this->gauge[dir][X];
+        if (backup_in_gauge) {
+            // write the updated field into the backup storage, the current
+            // field becomes the backup.  Swap only after the tasks are done
+#pragma omp parallel
+#pragma omp master
+            foralldir(dir) {
+#pragma hila omp_task
+                onsites(ALL) {
+                    element<matrix> momexp = (eps * this->momentum[dir][X]).exp();
+                    gauge_backup[dir][X] = momexp * this->gauge[dir][X];
+                }
+            }
+            foralldir(dir) hila::swap(this->gauge[dir], gauge_backup[dir]);
+            backup_in_gauge = false;
+        } else {
+#pragma omp parallel
+#pragma omp master
+            foralldir(dir) {
+#pragma hila omp_task
+                onsites(ALL) {
+                    element<matrix> momexp = (eps * this->momentum[dir][X]).exp();
+                    this->gauge[dir][X] = momexp * this->gauge[dir][X];
+                }
             }
         }
+        this->mark_changed();
     }
 
     /// Project a force term to the algebra and add to the
     /// momentum
     void add_momentum(Field<SquareMatrix<N, Complex<basetype>>> *force) {
+#pragma omp parallel
+#pragma omp master
         foralldir(dir) {
+#pragma hila omp_task
             onsites(ALL) {
                 force[dir][X] = this->gauge[dir][X] * force[dir][X];
                 project_antihermitean(force[dir][X]);
@@ -256,18 +322,38 @@ template <typename matrix> class gauge_field : public gauge_field_base<matrix> {
         }
     }
 
-    /// Make a copy of fields updated in a trajectory
-    void backup() { foralldir(dir) gauge_backup[dir] = this->gauge[dir]; }
+    /// Save the gauge field for HMC, without copying (see gauge_backup)
+    void backup() {
+        backup_version = this->version;
+        backup_in_gauge = true;
+    }
 
-    /// Restore the previous backup
-    void restore_backup() { foralldir(dir) this->gauge[dir] = gauge_backup[dir]; }
+    /// Restore the previous backup by swapping it with the current field
+    void restore_backup() {
+        if (backup_version < 0)
+            hila::error("gauge_field: restore_backup() called without backup()");
+        if (backup_in_gauge) {
+            // gauge[] should not have been modified in place without detach_backup()
+            if (this->version != backup_version)
+                hila::error("gauge_field: field modified after backup() without "
+                            "detach_backup(), backup lost");
+            return;
+        }
+        foralldir(dir) hila::swap(this->gauge[dir], gauge_backup[dir]);
+        this->mark_changed();
+        // the restored field is again the backup
+        backup_version = this->version;
+        backup_in_gauge = true;
+    }
 
     /// Read the gauge field from a file
     void read_file(std::string filename) {
+        detach_backup();
         std::ifstream inputfile;
         inputfile.open(filename, std::ios::in | std::ios::binary);
         foralldir(dir) { read_fields(inputfile, this->gauge[dir]); }
         inputfile.close();
+        this->mark_changed();
     }
 
     /// Write the gauge field to a file
@@ -288,8 +374,17 @@ template <typename matrix> class gauge_field : public gauge_field_base<matrix> {
 
     /// Return a reference to the momentum field
     Field<gauge_type> &get_momentum(int dir) { return this->momentum[dir]; }
-    /// Return a reference to the gauge field
-    Field<gauge_type> &get_gauge(int dir) { return this->gauge[dir]; }
+    /// Return a read-only reference to the gauge field
+    const Field<gauge_type> &get_gauge(int dir) const {
+        return this->gauge[dir];
+    }
+    /// Return a writable reference to the gauge field.  The field is marked
+    /// changed now, so get the reference again for each modification
+    Field<gauge_type> &modify_gauge(int dir) {
+        detach_backup();
+        this->mark_changed();
+        return this->gauge[dir];
+    }
 };
 
 /// A gauge field, similar to the standard gauge_field class above,
@@ -308,6 +403,8 @@ template <class repr> class represented_gauge_field : public gauge_field_base<re
     static constexpr int N = repr::size;
     /// Reference to the fundamental gauge field
     gauge_field<fund_type> &fundamental;
+    /// Version of the fundamental field the representation was computed from
+    int64_t refreshed_version = -1;
 
     /// Construct from a fundamental field
     represented_gauge_field(gauge_field<fund_type> &f) : fundamental(f) {
@@ -318,37 +415,43 @@ template <class repr> class represented_gauge_field : public gauge_field_base<re
         gauge_field_base<repr>();
     }
 
-    /// Represent the fields
+    /// Represent the fields. Does nothing if the fundamental field has not
+    /// changed since the last refresh.
     void refresh() {
+        if (refreshed_version == fundamental.version)
+            return;
+#pragma omp parallel
+#pragma omp master
         foralldir(dir) {
             this->gauge[dir].check_alloc();
+#pragma hila omp_task
             onsites(ALL) {
                 this->gauge[dir][X].represent(fundamental.gauge[dir][X]);
             }
         }
+        refreshed_version = fundamental.version;
+        this->mark_changed();
     }
 
     /// Set the gauge field to unity. This will set the
-    /// underlying fundamental field
-    void set_unity() {
-        fundamental.set_unity();
-        refresh();
-    }
+    /// underlying fundamental field, represented field is
+    /// computed when next needed
+    void set_unity() { fundamental.set_unity(); }
 
     /// Draw a random gauge field. This will set the
     /// underlying fundamental field
-    void random() {
-        fundamental.random();
-        refresh();
-    }
+    void random() { fundamental.random(); }
 
     /// Project a force term to the algebra and add to the
-    /// momentum
+    /// momentum. The link is represented on the fly from the fundamental
+    /// field, so this does not need an up-to-date represented field.
     void add_momentum(Field<SquareMatrix<N, Complex<basetype>>> (&force)[NDIM]) {
         foralldir(dir) {
             onsites(ALL) {
+                repr R;
+                R.represent(fundamental.gauge[dir][X]);
                 element<fund_type> fforce;
-                fforce = repr::project_force(this->gauge[dir][X] * force[dir][X]);
+                fforce = repr::project_force(R * force[dir][X]);
                 fundamental.momentum[dir][X] = fundamental.momentum[dir][X] + fforce;
             }
         }
@@ -370,8 +473,10 @@ template <class repr> class represented_gauge_field : public gauge_field_base<re
 
     /// Return a reference to the momentum field
     Field<fund_type> &get_momentum(int dir) { return fundamental.get_momentum(dir); }
-    /// Return a reference to the gauge Field
-    Field<fund_type> &get_gauge(int dir) { return fundamental.get_gauge(dir); }
+    /// Return a read-only reference to the fundamental gauge Field
+    const Field<fund_type> &get_gauge(int dir) const { return fundamental.get_gauge(dir); }
+    /// Return a writable reference to the fundamental gauge Field
+    Field<fund_type> &modify_gauge(int dir) { return fundamental.modify_gauge(dir); }
 };
 
 /// Shortcuts for represented gauge fields
@@ -441,6 +546,18 @@ class gauge_momentum_action : public action_base, public integrator_base {
     void step(double eps) { gauge.gauge_update(eps); }
 };
 
+/// Squared norm of the force |F|^2, summed over directions and sites,
+/// where the force fields contain F * eps.  Used for measuring the
+/// {S,{S,T}} Poisson bracket in HMC step size tuning.
+template <typename momtype>
+double force_norm_squared(Field<momtype> (&force)[NDIM], double eps) {
+    double fn = 0;
+    foralldir(dir) {
+        onsites(ALL) { fn += force[dir][X].squarenorm(); }
+    }
+    return fn / (eps * eps);
+}
+
 /// The Wilson plaquette action of a gauge field.
 /// Action terms contain a force_step()-function, which
 /// updates the momentum of the gauge field. To do this,
@@ -468,6 +585,7 @@ template <typename gauge_field> class gauge_action : public action_base {
 
     /// The gauge action
     double action() {
+        gauge.refresh();
         double Sg = beta * plaquette_sum(gauge.gauge);
         return Sg;
     }
@@ -476,10 +594,13 @@ template <typename gauge_field> class gauge_action : public action_base {
     void force_step(double eps) {
         Field<gauge_mat> staple;
         Field<momtype> force[NDIM];
+        gauge.refresh();
         foralldir(dir) {
             staple = calc_staples(gauge.gauge, dir);
             onsites(ALL) { force[dir][X] = (-beta * eps / N) * staple[X]; }
         }
+        if (measuring_force)
+            force_norm2 = force_norm_squared(force, eps);
         gauge.add_momentum(force);
     }
 };
@@ -3,6 +3,10 @@
 
 #include <sys/time.h>
 #include <ctime>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <vector>
 #include "integrator.h"
 
 /// The Hybrid Montecarlo algorithm.
@@ -12,8 +16,10 @@
 //
 // The integrator class must implement at least two functions,
 // action() an integrator_step(double eps)
+//
+// Returns the change of the action dH over the trajectory
 template <class integrator_type>
-void update_hmc(integrator_type &integrator, int steps, double traj_length) {
+double update_hmc(integrator_type &integrator, int steps, double traj_length) {
 
     static int accepted = 0, trajectory = 1;
     struct timeval start, end;
@@ -61,6 +67,203 @@ void update_hmc(integrator_type &integrator, int steps, double traj_length) {
 
     hila::out0 << "HMC done in " << timing << " seconds \n";
     trajectory++;
+
+    return end_action - start_action;
+}
+
+/// Integrator levels with force steps, top level first
+inline std::vector<integrator_base *> hmc_integrator_levels(integrator_base &integrator) {
+    std::vector<integrator_base *> levels;
+    for (integrator_base *i = &integrator; i != nullptr && i->stats() != nullptr;
+         i = i->lower())
+        levels.push_back(i);
+    return levels;
+}
+
+/// <dH> giving acceptance rate p, from p = erfc(sqrt(<dH>)/2).
+/// Inverted by bisection.
+inline double hmc_target_dH(double p) {
+    double lo = 0, hi = 10;
+    for (int i = 0; i < 60; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (std::erfc(mid) > p)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    double x = 0.5 * (lo + hi);
+    return 4 * x * x;
+}
+
+/// Tune the MD step sizes of the integrator levels during thermalization.
+///
+/// Runs n_trajectories HMC trajectories measuring the energy violation dH,
+/// and the force norms |F_l|^2 and the cost c_l of a force evaluation on each
+/// integrator level l.  The force norms give the {S,{S,T}} Poisson bracket
+/// terms of the shadow Hamiltonian.  For a second order integrator
+///   <dH> = <dH^2>/2 = kappa sum_l |F_l|^2 h_l^4,
+/// where h_l is the step size of level l.  kappa is fitted from the measured
+/// trajectories, and the step sizes are chosen to minimize the cost
+/// sum_l c_l / h_l at the target acceptance rate, giving
+///   h_l ~ (c_l / |F_l|^2)^(1/5).
+/// The step counts (top level steps and the integer step ratios of the
+/// levels below) are rounded to nearest, and set in the integrator.
+///
+/// The {T,{S,T}} bracket needs second derivatives of the action and is not
+/// measured; it is included in the fitted kappa.
+///
+/// Returns true if the step counts were tuned, false if they were left unchanged.
+template <class integrator_type>
+bool tune_hmc(integrator_type &integrator, int &steps, double traj_length,
+              int n_trajectories, double target_acceptance = 0.8) {
+
+    std::vector<integrator_base *> levels = hmc_integrator_levels(integrator);
+    int nl = levels.size();
+    if (nl == 0 || n_trajectories <= 0)
+        return false;
+
+    for (auto l : levels)
+        l->stats()->reset();
+    integrator.measure_force(true);
+
+    double dH2 = 0;
+    for (int t = 0; t < n_trajectories; t++) {
+        double dH = update_hmc(integrator, steps, traj_length);
+        dH2 += dH * dH;
+    }
+    integrator.measure_force(false);
+    dH2 /= n_trajectories;
+
+    // current step sizes, force norms and costs per force evaluation
+    std::vector<double> h(nl), f(nl), c(nl);
+    double hs = traj_length / steps;
+    for (int l = 0; l < nl; l++) {
+        auto st = levels[l]->stats();
+        h[l] = hs;
+        hs /= levels[l]->get_steps();
+        if (st->calls == 0 || st->force_norm2 <= 0) {
+            hila::out0 << "HMC tuning: no force measured on level " << l
+                       << ", keeping step sizes\n";
+            return false;
+        }
+        f[l] = st->force_norm2 / st->calls;
+        c[l] = levels[l]->force_steps_per_step() * st->time / st->calls;
+    }
+
+    double err = 0;
+    for (int l = 0; l < nl; l++)
+        err += f[l] * pow(h[l], 4);
+    double kappa = 0.5 * dH2 / err;
+    if (!(kappa > 0)) {
+        hila::out0 << "HMC tuning: dH vanishes, keeping step sizes\n";
+        return false;
+    }
+
+    // optimal step size ratios, scaled to the target <dH>
+    double target = hmc_target_dH(target_acceptance);
+    std::vector<double> a(nl);
+    double s4 = 0;
+    for (int l = 0; l < nl; l++) {
+        a[l] = pow(c[l] / f[l], 0.2);
+        s4 += f[l] * pow(a[l], 4);
+    }
+    double scale = pow(target / (kappa * s4), 0.25);
+
+    // convert to nested integer step counts
+    std::vector<int> n(nl);
+    steps = std::max(1L, std::lround(traj_length / (scale * a[0])));
+    hs = traj_length / steps;
+    for (int l = 0; l < nl; l++) {
+        if (l < nl - 1) {
+            n[l] = std::max(1L, std::lround(hs / (scale * a[l + 1])));
+            hs /= n[l];
+        } else {
+            // lowest level drives the momentum level, keep its step count
+            n[l] = levels[l]->get_steps();
+        }
+        levels[l]->set_steps(n[l]);
+    }
+
+    hila::out0 << "HMC tuning: <dH^2>/2 " << 0.5 * dH2 << " target <dH> " << target
+               << " kappa " << kappa << '\n';
+    hila::out0 << "HMC tuning: trajectory steps " << steps;
+    for (int l = 0; l < nl - 1; l++)
+        hila::out0 << ", level " << l + 1 << " steps " << n[l];
+    hila::out0 << '\n';
+    return true;
+}
+
+/// Write the HMC step parameters to file.  Call this only with tuned step counts, from
+/// tune_hmc() or read_hmc_parameters(), whenever the configuration is checkpointed, so
+/// that the step counts on disk belong to the saved configuration.  The trajectory length
+/// and target acceptance the steps were tuned for are stored too, at full precision:
+/// read_hmc_parameters() compares them exactly.
+template <class integrator_type>
+void write_hmc_parameters(const std::string &filename, integrator_type &integrator,
+                          int steps, double traj_length, double target_acceptance) {
+    if (hila::myrank() == 0) {
+        std::ofstream out(filename);
+        out.precision(std::numeric_limits<double>::max_digits10);
+        out << "steps " << steps << '\n';
+        out << "traj_length " << traj_length << '\n';
+        out << "target_acceptance " << target_acceptance << '\n';
+        out << "level_steps";
+        for (auto l : hmc_integrator_levels(integrator))
+            out << ' ' << l->get_steps();
+        out << '\n';
+    }
+}
+
+/// Read the HMC step parameters written by write_hmc_parameters() and set them
+/// in the integrator.  Every step count which differs from the current value is
+/// reported.  Returns false, leaving the steps unchanged, if the file is not found,
+/// does not match the integrator, or was tuned for a different trajectory length or
+/// target acceptance.
+template <class integrator_type>
+bool read_hmc_parameters(const std::string &filename, integrator_type &integrator,
+                         int &steps, double traj_length, double target_acceptance) {
+    std::vector<integrator_base *> levels = hmc_integrator_levels(integrator);
+    std::vector<int> n(levels.size());
+    int file_steps = 0;
+    double file_traj_length = 0, file_acceptance = 0;
+    int ok = 0;
+    if (hila::myrank() == 0) {
+        std::ifstream in(filename);
+        std::string label;
+        if (in >> label >> file_steps >> label >> file_traj_length >> label >>
+            file_acceptance >> label) {
+            int i = 0;
+            while (i < n.size() && in >> n[i])
+                i++;
+            ok = (i == n.size());
+        }
+    }
+    hila::broadcast(ok);
+    if (!ok)
+        return false;
+
+    hila::broadcast(file_steps);
+    hila::broadcast(file_traj_length);
+    hila::broadcast(file_acceptance);
+    hila::broadcast(n);
+
+    if (file_traj_length != traj_length || file_acceptance != target_acceptance) {
+        hila::out0 << "HMC: " << filename << " was tuned for traj_length " << file_traj_length
+                   << ", target_acceptance " << file_acceptance << ", not used\n";
+        return false;
+    }
+
+    if (file_steps != steps)
+        hila::out0 << "HMC: steps " << steps << " -> " << file_steps << " from " << filename
+                   << '\n';
+    steps = file_steps;
+    for (int l = 0; l < levels.size(); l++) {
+        if (levels[l]->get_steps() != n[l])
+            hila::out0 << "HMC: level " << l + 1 << " steps " << levels[l]->get_steps()
+                       << " -> " << n[l] << " from " << filename << '\n';
+        levels[l]->set_steps(n[l]);
+    }
+    return true;
 }
 
 #endif
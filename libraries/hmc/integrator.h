@@ -3,6 +3,7 @@
 
 #include <sys/time.h>
 #include <ctime>
+#include <vector>
 
 /// Define the standard action term class.
 /// Action terms are used in the HMC algorithm and
@@ -26,6 +27,18 @@ class action_base {
 
     /// Restore the previous backup
     virtual void restore_backup() {}
+
+    /// Turn measurement of the force norm on or off. When on,
+    /// force_step() stores |F|^2 / eps^2 summed over the lattice
+    /// in force_norm2.  Used in HMC step size tuning
+    virtual void measure_force(bool on) { measuring_force = on; }
+
+    /// Force norm from the last force_step(), if measured
+    virtual double last_force_norm2() { return force_norm2; }
+
+  protected:
+    bool measuring_force = false;
+    double force_norm2 = 0;
 };
 
 /// Represents a sum of two action terms. Useful for adding them
@@ -69,6 +82,15 @@ class action_sum : public action_base {
         a1.restore_backup();
         a2.restore_backup();
     }
+
+    /// Force norm measurement is done in the terms
+    void measure_force(bool on) {
+        a1.measure_force(on);
+        a2.measure_force(on);
+    }
+
+    /// Sum of force norms of the terms
+    double last_force_norm2() { return a1.last_force_norm2() + a2.last_force_norm2(); }
 };
 
 /// Sum operator for creating an action_sum object
@@ -77,6 +99,19 @@ action_sum operator+(action_base a1, action_base a2) {
     return sum;
 }
 
+/// Per-level measurements collected during HMC step size tuning,
+/// see tune_hmc() in hmc.h
+struct integrator_level_stats {
+    /// summed force norm |F|^2 / eps^2 over measured force steps
+    double force_norm2 = 0;
+    /// wall clock time spent in force steps
+    double time = 0;
+    /// number of measured force steps
+    int64_t calls = 0;
+
+    void reset() { *this = integrator_level_stats(); }
+};
+
 /// A base for an integrator. An integrator updates the gauge and
 /// momentum fields in the HMC trajectory, approximately conserving
 /// the action
@@ -101,6 +136,25 @@ class integrator_base {
 
     /// Run a lower level integrator step
     virtual void step(double eps) {}
+
+    /// The following are used for step size tuning. Levels are numbered
+    /// from the top, the lowest (momentum) level has no force steps.
+
+    /// Integrator on the next level below, nullptr for the lowest level
+    virtual integrator_base *lower() { return nullptr; }
+
+    /// Number of lower level steps for each step on this level
+    virtual int get_steps() { return 1; }
+    virtual void set_steps(int steps) {}
+
+    /// Number of force evaluations in one step on this level
+    virtual int force_steps_per_step() { return 0; }
+
+    /// Force measurements on this level, nullptr for the lowest level
+    virtual integrator_level_stats *stats() { return nullptr; }
+
+    /// Turn force measurement on or off on this and all lower levels
+    virtual void measure_force(bool on) {}
 };
 
 /// Build integrator hierarchically by adding a force step on
@@ -112,12 +166,19 @@ class action_term_integrator : public integrator_base {
     action_base &action_term;
     /// Lower level integrator, updates the momentum
     integrator_base &lower_integrator;
+    /// Number of lower level steps for each step on this level
+    int n = 1;
+    /// Force measurements, collected when measuring is on
+    integrator_level_stats level_stats;
+    bool measuring = false;
 
     /// Constructor from action and lower level integrator.
     /// also works with momentum actions as long as it inherits
     /// the integrator_base.
     action_term_integrator(action_base &a, integrator_base &i)
         : action_term(a), lower_integrator(i) {}
+    action_term_integrator(action_base &a, integrator_base &i, int steps)
+        : action_term(a), lower_integrator(i), n(steps) {}
 
     /// The current total action of fields updated by this
     /// integrator. This is kept constant up to order eps^3.
@@ -143,22 +204,44 @@ class action_term_integrator : public integrator_base {
     }
 
     /// Update the momentum with the gauge field
-    void force_step(double eps) { action_term.force_step(eps); }
+    void force_step(double eps) {
+        if (!measuring) {
+            action_term.force_step(eps);
+            return;
+        }
+        double t0 = hila::gettime();
+        action_term.force_step(eps);
+        level_stats.time += hila::gettime() - t0;
+        level_stats.force_norm2 += action_term.last_force_norm2();
+        level_stats.calls++;
+    }
 
     /// Update the gauge field with momentum
     void momentum_step(double eps) { lower_integrator.step(eps); }
+
+    integrator_base *lower() { return &lower_integrator; }
+    int get_steps() { return n; }
+    void set_steps(int steps) { n = steps; }
+    integrator_level_stats *stats() { return &level_stats; }
+
+    void measure_force(bool on) {
+        measuring = on;
+        action_term.measure_force(on);
+        lower_integrator.measure_force(on);
+    }
 };
 
 /// Define an integration step for a Molecular Dynamics
 /// trajectory.
 class leapfrog_integrator : public action_term_integrator {
   public:
-    int n = 1;
     leapfrog_integrator(action_base &a, integrator_base &i, int steps)
-        : action_term_integrator(a, i), n(steps) {}
+        : action_term_integrator(a, i, steps) {}
     leapfrog_integrator(action_base &a, integrator_base &i)
         : action_term_integrator(a, i) {}
 
+    int force_steps_per_step() { return 1; }
+
     // Run the integrator update
     void step(double eps) {
         for (int i = 0; i < n; i++)
@@ -173,12 +256,12 @@ class leapfrog_integrator : public action_term_integrator {
 /// trajectory.
 class O2_integrator : public action_term_integrator {
   public:
-    int n = 1;
-
     O2_integrator(action_base &a, integrator_base &i, int steps)
-        : action_term_integrator(a, i), n(steps) {}
+        : action_term_integrator(a, i, steps) {}
     O2_integrator(action_base &a, integrator_base &i) : action_term_integrator(a, i) {}
 
+    int force_steps_per_step() { return 2; }
+
     // Run the integrator update
     void step(double eps) {
         double zeta = eps * 0.1931833275037836;
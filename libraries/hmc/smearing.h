@@ -86,6 +86,8 @@ template <typename sun> class stout_smeared_field : public gauge_field_base<sun>
     int exp_steps = 10;
 
     gauge_field<sun> &base_field;
+    /// Version of the base field the smeared field was computed from
+    int64_t refreshed_version = -1;
     Field<sun> **staples;
     Field<sun> **smeared_fields;
 
@@ -131,8 +133,10 @@ template <typename sun> class stout_smeared_field : public gauge_field_base<sun>
         free(smeared_fields);
     }
 
-    // Represent the fields
+    // Smear the fields, if the base field has changed since the last refresh
     void refresh() {
+        if (refreshed_version == base_field.version)
+            return;
         Field<sun> *previous;
         previous = &base_field.gauge[0];
 
@@ -150,19 +154,19 @@ template <typename sun> class stout_smeared_field : public gauge_field_base<sun>
             }
             previous = smeared_fields[step];
         }
+        refreshed_version = base_field.version;
+        this->mark_changed();
     }
 
-    void set_unity() {
-        base_field.set_unity();
-        refresh();
-    }
+    // The smeared field is computed when next needed
+    void set_unity() { base_field.set_unity(); }
 
-    void random() {
-        base_field.random();
-        refresh();
-    }
+    void random() { base_field.random(); }
 
     void add_momentum(Field<SquareMatrix<N, Complex<basetype>>> *force) {
+        // staples and smeared fields of the current base field
+        refresh();
+
         // Two storage fields for the current and previous levels of the force
         Field<SquareMatrix<N, Complex<basetype>>> storage1[NDIM];
         Field<SquareMatrix<N, Complex<basetype>>> storage2[NDIM];
@@ -232,7 +236,8 @@ template <typename sun> class stout_smeared_field : public gauge_field_base<sun>
     void restore_backup() { base_field.restore_backup(); }
 
     Field<sun> &get_momentum(int dir) { return base_field.get_momentum(dir); }
-    Field<sun> &get_gauge(int dir) { return base_field.get_gauge(dir); }
+    const Field<sun> &get_gauge(int dir) const { return base_field.get_gauge(dir); }
+    Field<sun> &modify_gauge(int dir) { return base_field.modify_gauge(dir); }
 };
 
 #if NDIM == 4
@@ -251,6 +256,8 @@ template <typename sun> struct HEX_smeared_field : public gauge_field_base<sun>
     int exp_steps = 10;
 
     gauge_field<sun> &base_field;
+    /// Version of the base field the smeared field was computed from
+    int64_t refreshed_version = -1;
     Field<sun> staples3[NDIM][NDIM];
     Field<sun> level3[NDIM][NDIM];
     Field<sun> staples2[NDIM][NDIM];
@@ -274,8 +281,10 @@ template <typename sun> struct HEX_smeared_field : public gauge_field_base<sun>
         gauge_field_base<sun>();
     }
 
-    // Represent the fields
+    // Smear the fields, if the base field has changed since the last refresh
     void refresh() {
+        if (refreshed_version == base_field.version)
+            return;
         Field<sun> *previous;
         previous = &base_field.gauge[0];
 
@@ -329,19 +338,19 @@ template <typename sun> struct HEX_smeared_field : public gauge_field_base<sun>
                 this->gauge[mu][X] = base_field.gauge[mu][X] * Q;
             }
         }
+        refreshed_version = base_field.version;
+        this->mark_changed();
     }
 
-    void set_unity() {
-        base_field.set_unity();
-        refresh();
-    }
+    // The smeared field is computed when next needed
+    void set_unity() { base_field.set_unity(); }
 
-    void random() {
-        base_field.random();
-        refresh();
-    }
+    void random() { base_field.random(); }
 
     void add_momentum(Field<SquareMatrix<N, Complex<basetype>>> *force) {
+        // staples and smeared levels of the current base field
+        refresh();
+
         Field<sun> lambda1[NDIM];
         Field<SquareMatrix<N, Complex<basetype>>> result1[NDIM][NDIM];
         Field<sun> lambda2[NDIM][NDIM];
@@ -458,7 +467,8 @@ template <typename sun> struct HEX_smeared_field : public gauge_field_base<sun>
     void restore_backup() { base_field.restore_backup(); }
 
     Field<sun> &get_momentum(int dir) { return base_field.get_momentum(dir); }
-    Field<sun> &get_gauge(int dir) { return base_field.get_gauge(dir); }
+    const Field<sun> &get_gauge(int dir) const { return base_field.get_gauge(dir); }
+    Field<sun> &modify_gauge(int dir) { return base_field.modify_gauge(dir); }
 };
 
 #endif
@@ -0,0 +1,206 @@
+#ifndef SYMPLECTIC_INTEGRATOR_H
+#define SYMPLECTIC_INTEGRATOR_H
+
+#include <vector>
+#include <cmath>
+#include "hila.h"
+
+/// Symplectic integrators for Hamiltonian evolution of fields, H = T(p) + S(q).
+/// The integrated system is a class with the methods
+///
+///   void position_step(double eps)        q -> q evolved with momentum p over time eps
+///   void momentum_step(double eps)        p -> p + eps F(q), F = force
+///   void force_gradient_step(double eps, double xi)
+///                                         p -> p + eps F(q'), where q' is q evolved
+///                                         over time 1 with momentum xi F(q).  q is
+///                                         not changed.  Only needed by force_gradient.
+///
+/// and is evolved over 'steps' steps of size dt with
+///
+///   hila::symplectic_integrate(system, scheme, steps, dt);
+///
+/// Position and momentum updates of consecutive steps are merged, so that the number of
+/// force evaluations per step is given by hila::force_evaluations(scheme):
+///
+///   leapfrog         1   2nd order
+///   omelyan          2   2nd order, error ~ 1/10 of leapfrog with the same dt
+///   yoshida4         3   4th order, 3 leapfrog steps of sizes w1, w0, w1
+///   force_gradient   3   4th order, Omelyan-Yin-Mawhinney scheme with a force gradient
+///                        stage.  The force gradient costs 1 extra force evaluation.
+///
+/// For gauge fields the class hila::gauge_md_system below implements the system using
+/// the position and momentum updates of the application.
+
+namespace hila {
+
+enum class integrator_scheme { leapfrog, omelyan, yoshida4, force_gradient };
+
+/// names of the schemes, in the order of integrator_scheme; can be given to
+/// hila::input::get_item()
+inline const std::vector<std::string> &integrator_scheme_names() {
+    static const std::vector<std::string> names = {"leapfrog", "omelyan", "yoshida4",
+                                                   "force gradient"};
+    return names;
+}
+
+/// Number of force evaluations in one step
+inline int force_evaluations(integrator_scheme scheme) {
+    switch (scheme) {
+    case integrator_scheme::leapfrog:
+        return 1;
+    case integrator_scheme::omelyan:
+        return 2;
+    default:
+        return 3;
+    }
+}
+
+/// One stage of an integrator step
+struct integrator_stage {
+    enum kind_t { position, momentum, force_gradient } kind;
+    double eps;
+    double xi;
+};
+
+/// Stages of a single step of size eps
+inline std::vector<integrator_stage> integrator_step_stages(integrator_scheme scheme,
+                                                            double eps) {
+    using st = integrator_stage;
+    std::vector<integrator_stage> s;
+
+    switch (scheme) {
+    case integrator_scheme::leapfrog:
+        s = {{st::position, 0.5 * eps, 0},
+             {st::momentum, eps, 0},
+             {st::position, 0.5 * eps, 0}};
+        break;
+
+    case integrator_scheme::omelyan: {
+        // same as in O2_integrator
+        double lambda = 0.1931833275037836;
+        s = {{st::position, lambda * eps, 0},
+             {st::momentum, 0.5 * eps, 0},
+             {st::position, (1 - 2 * lambda) * eps, 0},
+             {st::momentum, 0.5 * eps, 0},
+             {st::position, lambda * eps, 0}};
+        break;
+    }
+
+    case integrator_scheme::yoshida4: {
+        double c = std::cbrt(2.0);
+        double w1 = 1.0 / (2.0 - c);
+        double w0 = -c / (2.0 - c);
+        for (double w : {w1, w0, w1}) {
+            s.push_back({st::position, 0.5 * w * eps, 0});
+            s.push_back({st::momentum, w * eps, 0});
+            s.push_back({st::position, 0.5 * w * eps, 0});
+        }
+        break;
+    }
+
+    case integrator_scheme::force_gradient:
+        s = {{st::momentum, eps / 6, 0},
+             {st::position, 0.5 * eps, 0},
+             {st::force_gradient, 2 * eps / 3, eps * eps / 24},
+             {st::position, 0.5 * eps, 0},
+             {st::momentum, eps / 6, 0}};
+        break;
+    }
+    return s;
+}
+
+/// Evolve system over steps steps of size dt with the given scheme, see above
+template <typename system_t>
+void symplectic_integrate(system_t &system, integrator_scheme scheme, int steps, double dt) {
+
+    // collect all stages and merge consecutive position and momentum updates
+    std::vector<integrator_stage> stages;
+    for (int n = 0; n < steps; n++) {
+        for (const auto &s : integrator_step_stages(scheme, dt)) {
+            if (!stages.empty() && stages.back().kind == s.kind &&
+                s.kind != integrator_stage::force_gradient)
+                stages.back().eps += s.eps;
+            else
+                stages.push_back(s);
+        }
+    }
+
+    for (const auto &s : stages) {
+        switch (s.kind) {
+        case integrator_stage::position:
+            system.position_step(s.eps);
+            break;
+        case integrator_stage::momentum:
+            system.momentum_step(s.eps);
+            break;
+        case integrator_stage::force_gradient:
+            system.force_gradient_step(s.eps, s.xi);
+            break;
+        }
+    }
+}
+
+/// Base class for the evolution of a gauge field U with momentum E.  The application
+/// defines the updates
+///
+///   move_U(U, E, eps)      U -> exp(eps E) U
+///   add_force(U, E, eps)   E -> E + eps F(U)
+///
+/// and the integrator stages are built from these.  For example
+///
+///   template <typename group>
+///   struct realtime_system : hila::gauge_md_system<group> {
+///       using hila::gauge_md_system<group>::gauge_md_system;
+///       void move_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E,
+///                   double eps) override { update_U(U, E, eps); }
+///       void add_force(const GaugeField<group> &U, VectorField<Algebra<group>> &E,
+///                      double eps) override { update_E(U, E, eps); }
+///   };
+///
+///   realtime_system<group> sys(U, E);
+///   hila::symplectic_integrate(sys, scheme, steps, dt);
+
+template <typename group>
+class gauge_md_system {
+  public:
+    GaugeField<group> &U;
+    VectorField<Algebra<group>> &E;
+
+    gauge_md_system(GaugeField<group> &u, VectorField<Algebra<group>> &e) : U(u), E(e) {}
+    virtual ~gauge_md_system() = default;
+
+    virtual void move_U(GaugeField<group> &U, const VectorField<Algebra<group>> &E,
+                        double eps) = 0;
+    virtual void add_force(const GaugeField<group> &U, VectorField<Algebra<group>> &E,
+                           double eps) = 0;
+
+    void position_step(double eps) {
+        move_U(U, E, eps);
+    }
+
+    void momentum_step(double eps) {
+        add_force(U, E, eps);
+    }
+
+    /// E -> E + eps F(U'), U' = exp(xi F(U)) U.  To leading order in xi this adds
+    /// the force gradient term xi eps (dF/dU) F to the momentum.
+    void force_gradient_step(double eps, double xi) {
+        static hila::timer fg_timer("Force gradient step");
+        fg_timer.start();
+
+        VectorField<Algebra<group>> F;
+        GaugeField<group> U_saved = U;
+        foralldir(d) F[d] = 0;
+
+        add_force(U, F, xi);
+        move_U(U, F, 1.0);
+        add_force(U, E, eps);
+
+        U = U_saved;
+        fg_timer.stop();
+    }
+};
+
+} // namespace hila
+
+#endif
@@ -22,7 +22,11 @@
 #%   EVEN_SITES_FIRST=0      - store sites in logical "typewriter" order, mixing EVEN and ODD
 #%         sites. Default layout stores even lattice sites first, enabling efficient
 #%         looping over parities (EVEN/ODD).
+#%   COMPACT_COORDINATES=1   - compute site coordinates from x-row tables instead of storing
+#%         coordinates of all sites. Saves memory on large nodes (default: off)
 #%   NO_INTERLEAVE=1         - turn off compute during MPI communications (default: on)
+#%   THREAD_POOL=1           - with ARCH=openmp, run site loops on a persistent thread pool
+#%         instead of an OpenMP parallel region for each loop (default: off)
 #% GPU-relevant options:
 #%   GPU_AWARE_MPI=0         - turn off GPU aware MPI (default: on) 
 #%   GPU_SYNCHRONIZE_TIMERS=1 - Synchronize timers with GPU kernels.
@@ -137,10 +141,32 @@ HILA_OPTS += -DEVEN_SITES_FIRST=0
 endif
 endif
 
+ifdef COMPACT_COORDINATES
+ifneq ($(COMPACT_COORDINATES),0)
+HILA_OPTS += -DCOMPACT_COORDINATES
+endif
+endif
+
 ifdef NO_INTERLEAVE
 HILAPP_OPTS += --no-interleave
 endif
 
+ifdef THREAD_POOL
+ifneq ($(THREAD_POOL),0)
+ifeq (,$(findstring -target:openmp,$(HILAPP_OPTS)))
+  $(info ########################################################################)
+  $(info THREAD_POOL=1 needs an OpenMP target architecture, e.g. ARCH=openmp.)
+  $(info ARCH=$(ARCH) does not use -target:openmp)
+  $(info ########################################################################)
+  $(error )
+endif
+HILAPP_OPTS += --thread-pool
+HILA_OPTS += -DTHREAD_POOL
+HILA_OBJECTS += build/thread_pool.o
+LDFLAGS += -pthread
+endif
+endif
+
 ifdef GPU_SYNCHRONIZE_TIMERS
 HILA_OPTS += -DGPU_SYNCHRONIZE_TIMERS
 endif
@@ -5,11 +5,22 @@
 
 #define VANILLA
 
+#if defined(THREAD_POOL)
+#include "plumbing/thread_pool.h"
+#endif
+
 // Define random number generator
 namespace hila {
 
+#if defined(THREAD_POOL)
+// Barrier of the pool threads within site loops, no-op elsewhere
+inline void synchronize_threads() {
+    hila::thread_pool::barrier();
+}
+#else
 // Trivial synchronization
 inline void synchronize_threads() {}
+#endif
 
 /// Implements test for basic in types, similar to
 /// std::is_arithmetic, but allows the backend to add
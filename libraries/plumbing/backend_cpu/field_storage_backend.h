@@ -19,13 +19,15 @@ inline void field_storage<T>::set(const T &value, const unsigned i,
 }
 
 template <typename T>
-void field_storage<T>::allocate_field(const lattice_struct &lattice) {
-    fieldbuf = (T *)memalloc(sizeof(T) * lattice.field_alloc_size());
+size_t field_storage<T>::allocate_field(const lattice_struct &lattice) {
+    size_t bytes = sizeof(T) * lattice.field_alloc_size();
+    fieldbuf = (T *)memalloc(bytes);
     if (fieldbuf == nullptr) {
         std::cout << "Failure in Field memory allocation\n";
         exit(1);
     }
 #pragma acc enter data create(fieldbuf)
+    return bytes;
 }
 
 template <typename T>
@@ -6,13 +6,15 @@
 
 /* CUDA / HIP implementations */
 template <typename T>
-void field_storage<T>::allocate_field(const lattice_struct &lattice) {
+size_t field_storage<T>::allocate_field(const lattice_struct &lattice) {
     // Allocate space for the field of the device
-    gpuMalloc(&fieldbuf, sizeof(T) * lattice.field_alloc_size());
+    size_t bytes = sizeof(T) * lattice.field_alloc_size();
+    gpuMalloc(&fieldbuf, bytes);
     if (fieldbuf == nullptr) {
         std::cout << "Failure in field memory allocation\n";
     }
     assert(fieldbuf != nullptr);
+    return bytes;
 }
 
 template <typename T>
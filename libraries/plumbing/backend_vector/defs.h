@@ -317,6 +317,42 @@ inline double reduce_prod(Vec8q v) {
     return sum;
 }
 
+#ifndef HILAPP
+namespace hila {
+
+// Lane-wise select and mask test for vector types, see plumbing/real_var_ops.h
+inline Vec4d lane_select(Vec4db mask, Vec4d a, Vec4d b) {
+    return select(mask, a, b);
+}
+inline Vec8f lane_select(Vec8fb mask, Vec8f a, Vec8f b) {
+    return select(mask, a, b);
+}
+inline Vec8d lane_select(Vec8db mask, Vec8d a, Vec8d b) {
+    return select(mask, a, b);
+}
+inline Vec16f lane_select(Vec16fb mask, Vec16f a, Vec16f b) {
+    return select(mask, a, b);
+}
+
+inline bool all_lanes(Vec4db mask) {
+    return horizontal_and(mask);
+}
+inline bool all_lanes(Vec8fb mask) {
+    return horizontal_and(mask);
+}
+#if INSTRSET < 10
+// with AVX512VL Vec8fb and Vec8db are the same compact mask type
+inline bool all_lanes(Vec8db mask) {
+    return horizontal_and(mask);
+}
+#endif
+inline bool all_lanes(Vec16fb mask) {
+    return horizontal_and(mask);
+}
+
+} // namespace hila
+#endif
+
 // Return the
 template <typename base_t, typename vector_t, typename T, typename vecT>
 T reduce_sum_in_vector(const vecT &vt) {
@@ -62,15 +62,17 @@ template <typename T>
 using vector_type = typename vectorize_struct<T, hila::vector_info<T>::vector_size>::type;
 
 template <typename T>
-void field_storage<T>::allocate_field(const lattice_struct &lattice) {
+size_t field_storage<T>::allocate_field(const lattice_struct &lattice) {
+    size_t bytes;
     if constexpr (hila::is_vectorizable_type<T>::value) {
-        fieldbuf = (T *)memalloc(
-            lattice.backend_lattice->get_vectorized_lattice<hila::vector_info<T>::vector_size>()
-                ->field_alloc_size() *
-            sizeof(T));
+        bytes = lattice.backend_lattice->get_vectorized_lattice<hila::vector_info<T>::vector_size>()
+                    ->field_alloc_size() *
+                sizeof(T);
     } else {
-        fieldbuf = (T *)memalloc(sizeof(T) * lattice.field_alloc_size());
+        bytes = sizeof(T) * lattice.field_alloc_size();
     }
+    fieldbuf = (T *)memalloc(bytes);
+    return bytes;
 }
 
 template <typename T>
@@ -359,7 +361,79 @@ void field_storage<T>::gather_comm_vectors(
     }
 }
 
-// Place the received MPI elements to halo (neighbour) buffer
+/// Permute the lanes of vector v: lane i of the result is lane idx[i] of v
+template <typename V, typename I>
+inline V permute_lanes(const V &v, const I &idx) {
+    constexpr int n = I::size();
+    if constexpr (n == 4)
+        return lookup4(idx, v);
+    else if constexpr (n == 8)
+        return lookup8(idx, v);
+    else
+        return lookup16(idx, v);
+}
+
+/// Integer vector type for lane indices of vectors with base type B
+template <typename B, int vector_size>
+using lane_index_vector =
+    typename hila::vector_base_type<std::conditional_t<sizeof(B) == 8, int64_t, int>,
+                                    vector_size>::type;
+
+// Gather the boundary lanes for communications to directions with boundary permutation.
+// Sites in the sitelist come in groups of n_comm_lanes lanes of one vector.  The lanes
+// are permuted to the beginning of the vector in registers, and the buffer is packed as
+// [vector][element][lane], i.e. the buffer is not an array of T but it is unpacked with
+// place_recv_elements() below.
+template <typename T>
+void field_storage<T>::gather_comm_lanes(
+    T *RESTRICT buffer, const lattice_struct::comm_node_struct &to_node, Direction d,
+    Parity par, const vectorized_lattice_struct<hila::vector_info<T>::vector_size> *RESTRICT vlat,
+    bool antiperiodic) const {
+
+    constexpr size_t vector_size = hila::vector_info<T>::vector_size;
+    constexpr size_t elements = hila::vector_info<T>::elements;
+    using vectortype = typename hila::vector_info<T>::type;
+    using basetype = typename hila::vector_info<T>::base_type;
+
+    int n;
+    const unsigned *index_list = to_node.get_sitelist(par, n);
+
+    const int m = vlat->n_comm_lanes[d];
+    assert(m > 0 && n % m == 0);
+
+    lane_index_vector<basetype, vector_size> idx(0);
+    for (int l = 0; l < m; l++)
+        idx.insert(l, vlat->send_lanes[d][l]);
+
+    const basetype *fp = static_cast<const basetype *>(static_cast<const void *>(fieldbuf));
+    basetype *bp = static_cast<basetype *>(static_cast<void *>(buffer));
+
+    for (int j = 0; j < n / m; j++) {
+        const basetype *RESTRICT s = fp + (index_list[j * m] / vector_size) * elements * vector_size;
+        basetype *RESTRICT t = bp + j * m * elements;
+
+        for (unsigned e = 0; e < elements; e++) {
+            vectortype v;
+            v.load_a(s + e * vector_size);
+            v = permute_lanes(v, idx);
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+            if (antiperiodic)
+                v = -v;
+#endif
+            // full store spills over to the next elements, which are written after this;
+            // only the last elements of the vector need a partial store
+            if (e * m + vector_size <= elements * m)
+                v.store(t + e * m);
+            else
+                v.store_partial(m, t + e * m);
+        }
+    }
+}
+
+// Place the received MPI elements to halo (neighbour) buffer.  The buffer is packed by
+// gather_comm_lanes() above; received lanes are permuted to their positions in registers
+// and blended with the halo vector, the other lanes of which were set from the local
+// node by set_local_boundary_elements()
 template <typename T>
 void field_storage<T>::place_recv_elements(
     const T *RESTRICT buffer, Direction d, Parity par,
@@ -367,6 +441,7 @@ void field_storage<T>::place_recv_elements(
 
     constexpr size_t vector_size = hila::vector_info<T>::vector_size;
     constexpr size_t elements = hila::vector_info<T>::elements;
+    using vectortype = typename hila::vector_info<T>::type;
     using basetype = typename hila::vector_info<T>::base_type;
 
     unsigned start = 0;
@@ -376,19 +451,36 @@ void field_storage<T>::place_recv_elements(
     if (par != ALL)
         n /= 2;
 
+    const int m = vlat->n_comm_lanes[d];
+    assert(m > 0 && n % m == 0);
+
+    // inverse of the packing: lane recv_lanes[l] gets lane l of the buffer
+    lane_index_vector<basetype, vector_size> idx(0);
+    vectortype sel(0);
+    for (int l = 0; l < m; l++) {
+        idx.insert(vlat->recv_lanes[d][l], l);
+        sel.insert(vlat->recv_lanes[d][l], 1);
+    }
+    const auto mask = (sel != vectortype(0));
+
     // remove const  --  the payload of the buffer remains const, but the halo  bits are
     // changed
-    T *targetbuf = const_cast<T *>(fieldbuf);
-
-    for (unsigned i = 0; i < n; i++) {
-        unsigned idx = vlat->recv_list[d][i + start];
+    basetype *fp = static_cast<basetype *>(static_cast<void *>(const_cast<T *>(fieldbuf)));
+    const basetype *bp = static_cast<const basetype *>(static_cast<const void *>(buffer));
 
-        basetype *RESTRICT t = ((basetype *)targetbuf) +
-                               (idx / vector_size) * vector_size * elements + idx % vector_size;
-        const basetype *RESTRICT vp = (basetype *)(&buffer[i]);
+    for (unsigned j = 0; j < n / m; j++) {
+        basetype *RESTRICT t =
+            fp + (vlat->recv_list[d][start + j * m] / vector_size) * elements * vector_size;
+        const basetype *RESTRICT s = bp + j * m * elements;
 
         for (unsigned e = 0; e < elements; e++) {
-            t[e * vector_size] = vp[e];
+            vectortype v, h;
+            if (e * m + vector_size <= elements * m)
+                v.load(s + e * m);
+            else
+                v.load_partial(m, s + e * m);
+            h.load_a(t + e * vector_size);
+            select(mask, permute_lanes(v, idx), h).store_a(t + e * vector_size);
         }
     }
 }
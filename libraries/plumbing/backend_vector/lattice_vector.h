@@ -46,6 +46,10 @@ struct vectorized_lattice_struct {
     unsigned *recv_list[NDIRS];
     /// The size of the receive list in each direction
     unsigned recv_list_size[NDIRS];
+    /// With boundary permutation and MPI, the lanes of the boundary vectors which are
+    /// sent and received.  These are the same for all boundary vectors
+    int n_comm_lanes[NDIRS];
+    int send_lanes[NDIRS][vector_size], recv_lanes[NDIRS][vector_size];
 
     // coordinate offsets to nodes
     using int_vector_t = typename hila::vector_base_type<int, vector_size>::type;
@@ -53,7 +57,9 @@ struct vectorized_lattice_struct {
     // using coordinate_compound_vec_type = typename Vector<NDIM,
     // typename vector_base_type<int,vector_size>::type>; coordinate_compound_vec_type
     // coordinate_offset;
+#ifndef COMPACT_COORDINATES
     CoordinateVector *RESTRICT coordinate_base;
+#endif
 
     /// Storage for neighbour indexes on each site
     unsigned *RESTRICT neighbours[NDIRS];
@@ -181,16 +187,20 @@ struct vectorized_lattice_struct {
 
         // check special case: 1st subnode is across the whole lattice to Direction d and
         // no boundary permutation
-        // we do the copy also in this case, in order to implement other boundary
-        // conditions Slows down a bit the periodic case, but with MPI comms this should
-        // make no difference
+        // With SPECIAL_BOUNDARY_CONDITIONS we do the copy also in this case, in order to
+        // implement other boundary conditions.  Otherwise the neighbours wrap around
+        // directly on the node, and gathers to this direction are no-ops
 
         foralldir (d) {
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
             if (lattice.nodes.n_divisions[d] == 1 && !is_boundary_permutation[d]) {
                 only_local_boundary_copy[d] = only_local_boundary_copy[-d] = true;
             } else {
                 only_local_boundary_copy[d] = only_local_boundary_copy[-d] = false;
             }
+#else
+            only_local_boundary_copy[d] = only_local_boundary_copy[-d] = false;
+#endif
         }
 
         // accumulate here points off-subnode (to halo)
@@ -308,10 +318,34 @@ struct vectorized_lattice_struct {
                 }
                 assert(j == recv_list_size[d]);
 
+                // The received sites come in groups of n_comm_lanes[d] lanes of the same
+                // halo vector, and the sent sites in groups of lanes of the same field
+                // vector.  Record the lanes, so that comms can be packed vector by vector
+                int m = 0;
+                while (m < recv_list_size[d] &&
+                       recv_list[d][m] / vector_size == recv_list[d][0] / vector_size)
+                    m++;
+                n_comm_lanes[d] = m;
+
+                int n;
+                const unsigned *sitelist = lattice.nn_comminfo[d].to_node.get_sitelist(ALL, n);
+                assert(n == recv_list_size[d] && n % m == 0);
+                for (int l = 0; l < m; l++) {
+                    recv_lanes[d][l] = recv_list[d][l] % vector_size;
+                    send_lanes[d][l] = sitelist[l] % vector_size;
+                }
+                for (int i = 0; i < n; i++) {
+                    assert(recv_list[d][i] % vector_size == recv_lanes[d][i % m] &&
+                           recv_list[d][i] / vector_size == recv_list[d][i - i % m] / vector_size);
+                    assert(sitelist[i] % vector_size == send_lanes[d][i % m] &&
+                           sitelist[i] / vector_size == sitelist[i - i % m] / vector_size);
+                }
+
             } else {
                 // now use halo_offset directly for buffer
                 recv_list[d] = nullptr;
                 recv_list_size[d] = 0;
+                n_comm_lanes[d] = 0;
             }
         }
     }
@@ -329,11 +363,23 @@ struct vectorized_lattice_struct {
                 coordinate_offset[d].insert(i, diff[d]);
         }
 
+#ifndef COMPACT_COORDINATES
         // and then set the coordinate_base with the original coords
         coordinate_base = (CoordinateVector *)memalloc(v_sites * sizeof(CoordinateVector));
         for (int i = 0; i < v_sites; i++) {
             coordinate_base[i] = lattice.coordinates(vector_size * i);
         }
+#endif
+    }
+
+    /// Coordinates of the 1st element of the vector.  With COMPACT_COORDINATES
+    /// computed from the lattice row tables, no per-vector storage
+    inline CoordinateVector base_coordinates(int idx) const {
+#ifndef COMPACT_COORDINATES
+        return coordinate_base[idx];
+#else
+        return lattice.coordinates(vector_size * idx);
+#endif
     }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -390,18 +436,23 @@ struct vectorized_lattice_struct {
         // std::array<typename vector_base_type<int,vector_size>::type ,NDIM> r;
         CoordinateVector_t<int_vector_t> r;
         // Vector<NDIM,int_vector_t> r;
+        const CoordinateVector base = base_coordinates(idx);
         foralldir (d)
-            r.e(d) = coordinate_offset[d] + coordinate_base[idx][d];
+            r.e(d) = coordinate_offset[d] + base[d];
         return r;
     }
 
     auto coordinate(unsigned idx, Direction d) const {
+#ifndef COMPACT_COORDINATES
         return coordinate_offset[d] + coordinate_base[idx][d];
+#else
+        return coordinate_offset[d] + lattice.coordinate(vector_size * idx, d);
+#endif
     }
 
     // parity is the same for all elements in vector, return scalar
     ::Parity site_parity(int idx) {
-        return coordinate_base[idx].parity();
+        return base_coordinates(idx).parity();
     }
 
     /// First index in a lattice loop
@@ -14,9 +14,11 @@
 #include <type_traits>
 
 #include "plumbing/defs.h"
+#include "datatypes/cmplx.h"
 #include "plumbing/coordinates.h"
 #include "plumbing/lattice.h"
 #include "plumbing/field_storage.h"
+#include "plumbing/site_access_plan.h"
 
 #include "plumbing/backend_vector/vector_types.h"
 
@@ -32,6 +34,10 @@ class Field;
 template <typename T>
 void ensure_field_operators_exist();
 
+namespace hila {
+class FieldStatistics;
+}
+
 #include "plumbing/ensure_loop_functions.h"
 
 /**
@@ -87,6 +93,12 @@ class Field {
         // diff. fields
         const unsigned *RESTRICT neighbours[NDIRS];
         hila::bc boundary_condition[NDIRS];
+        // twisted b.c.: phase for gathers from each direction, and the direction
+        // whose last layer gets the phase
+        Complex<double> twist_phase[NDIRS];
+        Direction twist_dir[NDIRS];
+        // gathers from these directions are no-ops, see set_gather_noops()
+        bool gather_is_noop[NDIRS];
 
         MPI_Request receive_request[3][NDIRS];
         MPI_Request send_request[3][NDIRS];
@@ -95,11 +107,14 @@ class Field {
         T *receive_buffer[NDIRS];
 #endif
         T *send_buffer[NDIRS];
+        /// bytes allocated for payload and MPI buffers, for memory accounting
+        size_t payload_bytes, comm_buffer_bytes;
         /**
          * @internal
          * @brief Initialize communication
          */
         void initialize_communication() {
+            comm_buffer_bytes = 0;
             for (int d = 0; d < NDIRS; d++) {
                 for (int p = 0; p < 3; p++)
                     gather_status_arr[p][d] = gather_status_t::NOT_DONE;
@@ -124,6 +139,51 @@ class Field {
                     payload.free_mpi_buffer(receive_buffer[d]);
 #endif
             }
+            if (comm_buffer_bytes > 0)
+                hila::memory_freed("Field MPI buffers", comm_buffer_bytes);
+        }
+
+        /**
+         * @internal
+         * @brief Find the directions where gathers are no-ops: the direction is not divided
+         * between nodes, so that the neighbour array wraps around on this node, and there
+         * are no halo elements to fill (periodic b.c., no vector boundary permutation or
+         * local boundary copy).  The result is the same on all nodes, thus skipping these
+         * gathers keeps the message tags in sync.
+         */
+        void set_gather_noops() {
+            for (Direction d = (Direction)0; d < NDIRS; ++d) {
+                bool noop = lattice.nn_comminfo[d].is_local;
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+                noop = noop && boundary_condition[d] == hila::bc::PERIODIC;
+#endif
+#ifdef VECTORIZED
+                if constexpr (hila::is_vectorizable_type<T>::value) {
+                    noop = noop && !vector_lattice->is_boundary_permutation[abs(d)] &&
+                           !vector_lattice->only_local_boundary_copy[d];
+                }
+#endif
+                gather_is_noop[d] = noop;
+            }
+        }
+
+        /**
+         * @internal
+         * @brief Allocate MPI send or receive buffer of n elements
+         */
+        T *allocate_mpi_buffer(unsigned n) {
+            comm_buffer_bytes += n * sizeof(T);
+            hila::memory_allocated("Field MPI buffers", n * sizeof(T));
+            return payload.allocate_mpi_buffer(n);
+        }
+
+        /**
+         * @internal
+         * @brief Memory accounting key of the payload, "Field<T>"
+         */
+        static const std::string &memory_key() {
+            static const std::string key = "Field<" + hila::type_name<T>() + ">";
+            return key;
         }
 
         /**
@@ -131,7 +191,8 @@ class Field {
          * @brief Allocate payload for lattice
          */
         void allocate_payload() {
-            payload.allocate_field(lattice);
+            payload_bytes = payload.allocate_field(lattice);
+            hila::memory_allocated(memory_key(), payload_bytes);
         }
 
         /**
@@ -140,6 +201,7 @@ class Field {
          */
         void free_payload() {
             payload.free_field();
+            hila::memory_freed(memory_key(), payload_bytes);
         }
 
 #ifndef VECTORIZED
@@ -210,6 +272,14 @@ class Field {
          */
         void set_local_boundary_elements(Direction dir, Parity par);
 
+        /**
+         * @internal
+         * @brief Multiply gathered elements by the twist phase of direction d, if the
+         * source site is on the last layer of the twist direction
+         */
+        void apply_twist(Direction d, T *RESTRICT buffer, const unsigned *RESTRICT index_list,
+                         int n) const;
+
         /**
          * @internal
          * @brief Gather a list of elements to a single node
@@ -387,6 +457,10 @@ class Field {
             fs->boundary_condition[dir] = hila::bc::PERIODIC;
             fs->boundary_condition[-dir] = hila::bc::PERIODIC;
         }
+        for (int d = 0; d < NDIRS; d++) {
+            fs->twist_phase[d] = 1;
+            fs->twist_dir[d] = (Direction)0;
+        }
 #endif
 
 #ifdef VECTORIZED
@@ -397,6 +471,7 @@ class Field {
             fs->vector_lattice = nullptr;
         }
 #endif
+        fs->set_gather_noops();
     }
 
     /**
@@ -492,6 +567,19 @@ class Field {
         fs->assigned_to |= parity_bits(p);
     }
 
+    /**
+     * @internal
+     * @brief Bookkeeping after a SiteRegion loop
+     * @details Gathers are invalidated for the whole parity p, but the Field is not marked
+     * assigned: the loop wrote only the sites of the region.
+     * @param p Field parity
+     */
+    void mark_changed_region(const Parity p) const {
+        unsigned assigned = fs->assigned_to;
+        mark_changed(p);
+        fs->assigned_to = assigned;
+    }
+
     /**
      * @internal
      * @brief Mark the Field already gathered, no need to communicate
@@ -608,6 +696,7 @@ class Field {
             fs->payload.neighbours[-dir] = lattice.backend_lattice->d_neighb_special[-dir];
         }
 #endif
+        fs->set_gather_noops();
 
         // Make sure boundaries get refreshed
         mark_changed(ALL);
@@ -617,6 +706,63 @@ class Field {
 #endif
     }
 
+    /**
+     * @brief Set twisted boundary condition in direction dir
+     * @details Elements gathered over the boundary from +dir are multiplied by phase, and
+     * from -dir by conj(phase), if the site is on the last layer of direction twist_dir,
+     * i.e. X.coordinate(twist_dir) == lattice.size(twist_dir) - 1.  With a center element
+     * phase on link field U[d2], gathered to direction d1, this puts the 't Hooft twist
+     * on the corner plaquettes of the (d1,d2) planes; see GaugeField::set_twist().
+     *
+     * Requires SPECIAL_BOUNDARY_CONDITIONS and a complex element type.  Not available
+     * on vectorized (AVX) or GPU targets.
+     *
+     * @param dir direction of the boundary
+     * @param twist_dir direction whose last layer gets the phase, != dir
+     * @param phase phase factor
+     */
+    void set_twisted_boundary_condition(Direction dir, Direction twist_dir,
+                                        Complex<double> phase) {
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+        static_assert(hila::contains_complex<T>::value,
+                      "Twisted boundary conditions need a complex Field element type");
+#if defined(VECTORIZED) || defined(CUDA) || defined(HIP)
+        hila::error("Twisted boundary conditions are not available on vectorized or GPU targets");
+#endif
+        if (!is_up_dir(dir)) {
+            dir = -dir;
+            phase = ::conj(phase);
+        }
+        if (abs(twist_dir) == dir)
+            hila::error("Twist direction must differ from the boundary direction");
+        check_alloc();
+        fs->twist_phase[dir] = phase;
+        fs->twist_phase[-dir] = ::conj(phase);
+        fs->twist_dir[dir] = fs->twist_dir[-dir] = abs(twist_dir);
+        set_boundary_condition(dir, hila::bc::TWISTED);
+#else
+        hila::error("Twisted boundary conditions need SPECIAL_BOUNDARY_CONDITIONS");
+#endif
+    }
+
+    /// Twist phase for gathers from direction dir, see set_twisted_boundary_condition()
+    Complex<double> get_twist_phase(Direction dir) const {
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+        return fs->twist_phase[dir];
+#else
+        return Complex<double>(1, 0);
+#endif
+    }
+
+    /// Direction whose last layer gets the twist phase
+    Direction get_twist_direction(Direction dir) const {
+#ifdef SPECIAL_BOUNDARY_CONDITIONS
+        return fs->twist_dir[dir];
+#else
+        return (Direction)0;
+#endif
+    }
+
     /**
      * @brief Get the boundary condition of the Field
      * @param dir Boundary condition in certain direction
@@ -648,7 +794,14 @@ class Field {
     template <typename A>
     void copy_boundary_condition(const Field<A> &rhs) {
         foralldir(dir) {
-            set_boundary_condition(dir, rhs.get_boundary_condition(dir));
+            if (rhs.get_boundary_condition(dir) == hila::bc::TWISTED) {
+                if constexpr (hila::contains_complex<T>::value)
+                    set_twisted_boundary_condition(dir, rhs.get_twist_direction(dir),
+                                                   rhs.get_twist_phase(dir));
+                else
+                    assert(0 && "Cannot copy twisted boundary condition to a real Field");
+            } else
+                set_boundary_condition(dir, rhs.get_boundary_condition(dir));
         }
     }
 
@@ -1236,6 +1389,19 @@ class Field {
     std::vector<T> get_elements(const std::vector<CoordinateVector> &coord_list,
                                 bool broadcast = false) const;
 
+    /**
+     * @brief Element access through a precomputed SiteAccessPlan
+     * @details get_elements() collects the elements to rank 0, or with broadcast = true
+     * to all ranks (allgather).  set_elements() sets and add_elements() adds to
+     * the elements at the plan sites.  elements must be same on all nodes.
+     * @param plan SiteAccessPlan made from the coordinate list
+     */
+    /** @{ */
+    std::vector<T> get_elements(const SiteAccessPlan &plan, bool broadcast = false) const;
+    void set_elements(const std::vector<T> &elements, const SiteAccessPlan &plan);
+    void add_elements(const std::vector<T> &elements, const SiteAccessPlan &plan);
+    /** @} */
+
     std::vector<T> get_subvolume(const CoordinateVector &cmin, const CoordinateVector &cmax,
                                  bool broadcast = false) const;
 
@@ -1401,6 +1567,16 @@ class Field {
      */
     T product(Parity par = Parity::all, bool allreduce = true) const;
 
+    /**
+     * @brief Sum of the Field over slices (hyperplanes) orthogonal to direction dir
+     * @details Returns a vector of lattice.size(dir) elements, element i is the sum over
+     * sites with X.coordinate(dir) == i.  Result is available on all ranks.
+     * @param dir Direction of the profile
+     * @param par Parity
+     * @return std::vector<T> profile
+     */
+    std::vector<T> slice_sum(Direction dir, Parity par = ALL) const;
+
     /**
      * @brief Declare gpu_reduce here, defined only for GPU targets
      * @internal
@@ -1448,6 +1624,24 @@ class Field {
      */
     T minmax(bool is_min, Parity par, CoordinateVector &loc) const;
 
+    /**
+     * @brief Count, min/max with locations, mean, variance and optional histogram of
+     * the Field in a single sweep.  See hila::FieldStatistics
+     * @name Statistics functions
+     * @param par ::Parity
+     * @param hist_min,hist_max histogram range [hist_min, hist_max)
+     * @param nbins number of histogram bins
+     * @return hila::FieldStatistics
+     */
+    /** @{ */
+    hila::FieldStatistics statistics(Parity par = ALL) const;
+    hila::FieldStatistics statistics(Parity par, double hist_min, double hist_max,
+                                     int nbins) const;
+    /** @} */
+
+    /// @internal common implementation of statistics()
+    hila::FieldStatistics statistics_(Parity par, hila::FieldStatistics &st) const;
+
     void random();
     void gaussian_random(double width = 1.0);
 
@@ -1979,8 +2173,34 @@ void Field<T>::gaussian_random(double width) {
     }
 #else
 
-    onsites(ALL) {
-        hila::gaussian_random((*this)[X], width);
+    if constexpr (std::is_floating_point<T>::value || hila::is_complex<T>::value) {
+        // scalar elements: batched calls of 64 Box-Muller pairs, written directly to the
+        // field in site index order
+        using atype = hila::arithmetic_type<T>;
+        constexpr int nr = sizeof(T) / sizeof(atype);
+        constexpr int chunk = 128 / nr;
+        double buf[nr * chunk];
+
+        check_alloc();
+        const int sites = lattice.mynode.volume();
+        for (int start = 0; start < sites; start += chunk) {
+            int n = std::min(chunk, sites - start);
+            hila::gaussrand_array(buf, nr * n, width);
+            for (int i = 0; i < n; i++) {
+                T v;
+                atype *a = reinterpret_cast<atype *>(&v);
+                for (int k = 0; k < nr; k++)
+                    a[k] = buf[nr * i + k];
+                set_value_at(v, start + i);
+            }
+        }
+        mark_changed(ALL);
+
+    } else {
+        // matrix types fill all elements of a site at once, see Matrix_t::gaussian_random()
+        onsites(ALL) {
+            hila::gaussian_random((*this)[X], width);
+        }
     }
 
 #endif
@@ -25,6 +25,13 @@ void Field<T>::field_struct::gather_comm_elements(
     } else {
         payload.gather_comm_elements(buffer, to_node, par, lattice, false);
     }
+#if !defined(CUDA) && !defined(HIP)
+    if (boundary_condition[d] == hila::bc::TWISTED && lattice.mynode.is_on_edge(-d)) {
+        int n;
+        const unsigned *index_list = to_node.get_sitelist(par, n);
+        apply_twist(d, buffer, index_list, n);
+    }
+#endif
 #else
     payload.gather_comm_elements(buffer, to_node, par, lattice, false);
 #endif
@@ -41,14 +48,8 @@ void Field<T>::field_struct::gather_comm_elements(
     if constexpr (hila::is_vectorizable_type<T>::value) {
         // now vectorized layout
         if (vector_lattice->is_boundary_permutation[abs(d)]) {
-            // with boundary permutation need to gather elems 1-by-1
-            int n;
-            const unsigned *index_list = to_node.get_sitelist(par, n);
-            if (!antiperiodic) {
-                payload.gather_elements(buffer, index_list, n, lattice);
-            } else {
-                payload.gather_elements_negated(buffer, index_list, n, lattice);
-            }
+            // with boundary permutation only some lanes of the vectors are sent
+            payload.gather_comm_lanes(buffer, to_node, d, par, vector_lattice, antiperiodic);
         } else {
             // without it, can do the full block
             payload.gather_comm_vectors(buffer, to_node, par, vector_lattice, antiperiodic);
@@ -105,6 +106,47 @@ void Field<T>::field_struct::set_local_boundary_elements(Direction dir, Parity p
     bool antiperiodic = false;
 #endif
     payload.set_local_boundary_elements(dir, par, lattice, antiperiodic);
+
+#if defined(SPECIAL_BOUNDARY_CONDITIONS) && !defined(VECTORIZED) && !defined(CUDA) && !defined(HIP)
+    // twisted: copy the boundary to the halo like antiperiodic, and multiply by phase
+    if (boundary_condition[dir] == hila::bc::TWISTED && lattice.mynode.is_on_edge(dir)) {
+        unsigned n, start = 0;
+        if (par == ODD) {
+            n = lattice.special_boundaries[dir].n_odd;
+            start = lattice.special_boundaries[dir].n_even;
+        } else {
+            if (par == EVEN)
+                n = lattice.special_boundaries[dir].n_even;
+            else
+                n = lattice.special_boundaries[dir].n_total;
+        }
+        T *buf = payload.get_buffer() + lattice.special_boundaries[dir].offset + start;
+        const unsigned *index_list = lattice.special_boundaries[dir].move_index + start;
+        payload.gather_elements(buf, index_list, n, lattice);
+        apply_twist(dir, buf, index_list, n);
+    }
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Multiply elements gathered from direction d by the twist phase.  index_list contains
+/// the source sites, which are on the opposite boundary - the twist direction coordinate
+/// is the same as on the receiving site.
+
+template <typename T>
+void Field<T>::field_struct::apply_twist(Direction d, T *RESTRICT buffer,
+                                         const unsigned *RESTRICT index_list, int n) const {
+    if constexpr (hila::contains_complex<T>::value) {
+        const Direction td = twist_dir[d];
+        const int last = lattice.size(td) - 1;
+        const Complex<hila::arithmetic_type<T>> phase = twist_phase[d];
+
+#pragma omp parallel for
+        for (int j = 0; j < n; j++) {
+            if (lattice.coordinate(index_list[j], td) == last)
+                buffer[j] *= phase;
+        }
+    }
 }
 
 
@@ -124,7 +166,7 @@ T *Field<T>::field_struct::get_receive_buffer(Direction d, Parity par,
     if (par == ODD)
         offs = from_node.sites / 2;
     if (receive_buffer[d] == nullptr) {
-        receive_buffer[d] = payload.allocate_mpi_buffer(from_node.sites);
+        receive_buffer[d] = allocate_mpi_buffer(from_node.sites);
     }
     return receive_buffer[d] + offs;
 
@@ -141,7 +183,7 @@ T *Field<T>::field_struct::get_receive_buffer(Direction d, Parity par,
         if (vector_lattice->is_boundary_permutation[abs(d)]) {
             // extra copy operation needed
             if (receive_buffer[d] == nullptr) {
-                receive_buffer[d] = payload.allocate_mpi_buffer(from_node.sites);
+                receive_buffer[d] = allocate_mpi_buffer(from_node.sites);
             }
             return receive_buffer[d] + offs;
         } else {
@@ -261,6 +303,11 @@ Field<T> &Field<T>::shift(const CoordinateVector &v, Field<T> &res, const Parity
 template <typename T>
 dir_mask_t Field<T>::start_gather(Direction d, Parity p) const {
 
+    // direction not divided between nodes and no halo to fill: the neighbour array
+    // wraps around on the node.  Same on all nodes, no message tag needed
+    if (fs->gather_is_noop[d])
+        return 0;
+
     // get the mpi message tag right away, to ensure that we are always synchronized
     // with the mpi calls -- some nodes might not need comms, but the tags must be in
     // sync
@@ -352,7 +399,7 @@ dir_mask_t Field<T>::start_gather(Direction d, Parity p) const {
         unsigned sites = to_node.n_sites(par);
 
         if (fs->send_buffer[d] == nullptr)
-            fs->send_buffer[d] = fs->payload.allocate_mpi_buffer(to_node.sites);
+            fs->send_buffer[d] = fs->allocate_mpi_buffer(to_node.sites);
 
         send_buffer = fs->send_buffer[d] + to_node.offset(par);
 
@@ -394,6 +441,9 @@ dir_mask_t Field<T>::start_gather(Direction d, Parity p) const {
 template <typename T>
 void Field<T>::wait_gather(Direction d, Parity p) const {
 
+    if (fs->gather_is_noop[d])
+        return;
+
     lattice_struct::nn_comminfo_struct &ci = lattice.nn_comminfo[d];
     lattice_struct::comm_node_struct &from_node = ci.from_node;
     lattice_struct::comm_node_struct &to_node = ci.to_node;
@@ -663,17 +713,88 @@ template <typename T>
 std::vector<T> Field<T>::get_elements(const std::vector<CoordinateVector> &coord_list,
                                       bool bcast) const {
 
-    std::vector<T> res;
-    if (hila::myrank() == 0)
-        res.resize(coord_list.size());
+    return get_elements(SiteAccessPlan(coord_list), bcast);
+}
 
-    fs->gather_elements(res.data(), coord_list);
-    if (bcast)
-        hila::broadcast(res);
 
+/// Get elements using precomputed SiteAccessPlan.  Elements are collected to rank 0
+/// with one MPI_Gatherv, or to all ranks with MPI_Allgatherv if bcast is true.
+template <typename T>
+std::vector<T> Field<T>::get_elements(const SiteAccessPlan &plan, bool bcast) const {
+
+    assert(plan.sites_on_rank.size() == lattice.n_nodes() && "SiteAccessPlan not set up");
+
+    std::vector<T> local(plan.local_index.size());
+    fs->payload.gather_elements(local.data(), plan.local_index.data(), local.size(), lattice);
+
+    bool receive = bcast || hila::myrank() == 0;
+    std::vector<T> packed;
+
+    if (hila::number_of_nodes() == 1) {
+        packed = std::move(local);
+    } else {
+        // counts and offsets are in elements, with a contiguous type of sizeof(T) bytes:
+        // byte counts would overflow int for large plans
+        if (plan.n > std::numeric_limits<int>::max())
+            hila::error("SiteAccessPlan too large for get_elements()");
+
+        MPI_Datatype element;
+        MPI_Type_contiguous(sizeof(T), MPI_BYTE, &element);
+        MPI_Type_commit(&element);
+
+        if (receive)
+            packed.resize(plan.n);
+
+        if (bcast) {
+            MPI_Allgatherv(local.data(), local.size(), element, packed.data(),
+                           plan.sites_on_rank.data(), plan.rank_offset.data(), element,
+                           lattice.mpi_comm_lat);
+        } else {
+            MPI_Gatherv(local.data(), local.size(), element, packed.data(),
+                        plan.sites_on_rank.data(), plan.rank_offset.data(), element, 0,
+                        lattice.mpi_comm_lat);
+        }
+        MPI_Type_free(&element);
+    }
+
+    std::vector<T> res;
+    if (receive) {
+        res.resize(plan.n);
+        for (size_t i = 0; i < plan.n; i++)
+            res[i] = packed[plan.order[i]];
+    }
     return res;
 }
 
+/// Set elements using precomputed SiteAccessPlan, local operation
+template <typename T>
+void Field<T>::set_elements(const std::vector<T> &elements, const SiteAccessPlan &plan) {
+    assert(elements.size() == plan.n && "vector size mismatch in set_elements");
+
+    std::vector<T> my_elements(plan.local_index.size());
+    for (size_t k = 0; k < my_elements.size(); k++)
+        my_elements[k] = elements[plan.local_pos[k]];
+    fs->payload.place_elements(my_elements.data(), plan.local_index.data(),
+                               my_elements.size(), lattice);
+    mark_changed(ALL);
+}
+
+/// Add to elements using precomputed SiteAccessPlan (scatter-add), local operation.
+/// Repeated coordinates in the plan add up.
+template <typename T>
+void Field<T>::add_elements(const std::vector<T> &elements, const SiteAccessPlan &plan) {
+    assert(is_initialized(ALL) && "Field not initialized yet");
+    assert(elements.size() == plan.n && "vector size mismatch in add_elements");
+
+    std::vector<T> buf(plan.unique_index.size());
+    fs->payload.gather_elements(buf.data(), plan.unique_index.data(), buf.size(), lattice);
+
+    for (size_t k = 0; k < plan.local_pos.size(); k++)
+        buf[plan.unique_slot[k]] += elements[plan.local_pos[k]];
+    fs->payload.place_elements(buf.data(), plan.unique_index.data(), buf.size(), lattice);
+    mark_changed(ALL);
+}
+
 
 /// get a subvolume of the field elements to all nodes
 template <typename T>
@@ -764,7 +885,7 @@ void Field<T>::set_local_data(const std::vector<T> &buffer) {
     T *data = (T *)d_malloc(sizeof(T) * lattice.mynode.volume());
     gpuMemcpy(data, buffer.data(), sizeof(T) * lattice.mynode.volume(), gpuMemcpyHostToDevice);
 #else
-    T *data = buffer.data();
+    const T *data = buffer.data();
 #endif
 
 #pragma hila novector direct_access(data)
@@ -0,0 +1,364 @@
+#ifndef FIELD_STATISTICS_H_
+#define FIELD_STATISTICS_H_
+
+#include "hila.h"
+
+#include <limits>
+
+namespace hila {
+
+//////////////////////////////////////////////////////////////////////////////////
+/// @brief Accumulator for single-pass statistics of a real-valued Field
+///
+/// @details Holds the number of sites, min and max values with their locations,
+/// mean and variance (Welford's algorithm), and optionally a fixed-bin histogram.
+/// Accumulators can be merged, which is used to combine thread- and node-level
+/// results.  Usually obtained through Field<T>::statistics():
+///
+///   hila::FieldStatistics st = f.statistics();
+///   hila::out0 << "mean " << st.mean() << " +- " << st.stddev() << '\n';
+///
+///   // with histogram of 100 bins over [0, 1)
+///   auto sh = f.statistics(ALL, 0.0, 1.0, 100);
+///   auto &h = sh.histogram();
+///
+/// The result is computed in one sweep over the sites and a single MPI allreduce.
+/// Values outside the histogram range are counted in underflow() and overflow().
+///
+
+class FieldStatistics {
+
+  private:
+    int64_t n_ = 0;
+    double mean_ = 0, m2_ = 0;
+    double min_ = std::numeric_limits<double>::max();
+    double max_ = std::numeric_limits<double>::lowest();
+    CoordinateVector minloc_ = 0, maxloc_ = 0;
+
+    double hist_min_ = 0, hist_max_ = 0;
+    std::vector<int64_t> hist_;
+    int64_t underflow_ = 0, overflow_ = 0;
+
+    // lexicographic comparison, used to break ties in min/max so that the result
+    // does not depend on merge order
+    static bool coord_less(const CoordinateVector &a, const CoordinateVector &b) {
+        foralldir(d) {
+            if (a[d] != b[d])
+                return a[d] < b[d];
+        }
+        return false;
+    }
+
+    // number of doubles in the packed header, see pack()
+    static constexpr int n_header = 7 + 2 * NDIM;
+
+    void pack(std::vector<double> &buf) const;
+    void unpack(const double *buf, int len);
+
+    static void mpi_merge_op(void *in, void *inout, int *len, MPI_Datatype *dtype);
+
+    template <typename T>
+    friend class ::Field;
+
+  public:
+    FieldStatistics() = default;
+
+    /// Set up histogram with nbins bins covering [hmin, hmax)
+    FieldStatistics(double hmin, double hmax, int nbins) {
+        set_histogram(hmin, hmax, nbins);
+    }
+
+    void set_histogram(double hmin, double hmax, int nbins) {
+        assert(nbins > 0 && hmax > hmin && "Invalid histogram range in FieldStatistics");
+        hist_min_ = hmin;
+        hist_max_ = hmax;
+        hist_.assign(nbins, 0);
+        underflow_ = overflow_ = 0;
+    }
+
+    /// Histogram bin of value v, -1 for underflow and nbins for overflow
+    inline int bin(double v) const {
+        if (v < hist_min_)
+            return -1;
+        int b = (int)((v - hist_min_) * hist_.size() / (hist_max_ - hist_min_));
+        return b < (int)hist_.size() ? b : (int)hist_.size();
+    }
+
+    /// Add one value at location loc
+    inline void add(double v, const CoordinateVector &loc) {
+        n_++;
+        double delta = v - mean_;
+        mean_ += delta / n_;
+        m2_ += delta * (v - mean_);
+        if (v < min_) {
+            min_ = v;
+            minloc_ = loc;
+        }
+        if (v > max_) {
+            max_ = v;
+            maxloc_ = loc;
+        }
+        if (hist_.size() > 0) {
+            int b = bin(v);
+            if (b < 0)
+                underflow_++;
+            else if (b >= (int)hist_.size())
+                overflow_++;
+            else
+                hist_[b]++;
+        }
+    }
+
+    /// Merge another accumulator into this one (Chan et al. parallel update).
+    /// Histograms must have the same binning.
+    void merge(const FieldStatistics &s) {
+        if (s.n_ == 0)
+            return;
+        if (n_ == 0) {
+            *this = s;
+            return;
+        }
+        int64_t n = n_ + s.n_;
+        double delta = s.mean_ - mean_;
+        mean_ += delta * s.n_ / n;
+        m2_ += s.m2_ + delta * delta * ((double)n_ * s.n_) / n;
+        n_ = n;
+
+        if (s.min_ < min_ || (s.min_ == min_ && coord_less(s.minloc_, minloc_))) {
+            min_ = s.min_;
+            minloc_ = s.minloc_;
+        }
+        if (s.max_ > max_ || (s.max_ == max_ && coord_less(s.maxloc_, maxloc_))) {
+            max_ = s.max_;
+            maxloc_ = s.maxloc_;
+        }
+
+        assert(hist_.size() == s.hist_.size() && "FieldStatistics histograms do not match");
+        for (size_t i = 0; i < hist_.size(); i++)
+            hist_[i] += s.hist_[i];
+        underflow_ += s.underflow_;
+        overflow_ += s.overflow_;
+    }
+
+    /// Combine the node-local results over all MPI ranks.  Single allreduce.
+    void allreduce();
+
+    int64_t count() const {
+        return n_;
+    }
+    double min() const {
+        return min_;
+    }
+    double max() const {
+        return max_;
+    }
+    const CoordinateVector &min_location() const {
+        return minloc_;
+    }
+    const CoordinateVector &max_location() const {
+        return maxloc_;
+    }
+    double mean() const {
+        return mean_;
+    }
+    /// Population variance (divided by count)
+    double variance() const {
+        return n_ > 0 ? m2_ / n_ : 0;
+    }
+    /// Sample variance (divided by count - 1)
+    double sample_variance() const {
+        return n_ > 1 ? m2_ / (n_ - 1) : 0;
+    }
+    double stddev() const {
+        return sqrt(variance());
+    }
+
+    const std::vector<int64_t> &histogram() const {
+        return hist_;
+    }
+    int64_t underflow() const {
+        return underflow_;
+    }
+    int64_t overflow() const {
+        return overflow_;
+    }
+    /// Lower edge of histogram bin i
+    double bin_edge(int i) const {
+        return hist_min_ + i * (hist_max_ - hist_min_) / hist_.size();
+    }
+};
+
+
+/// Pack to double buffer: n, mean, m2, min, max, minloc, maxloc, underflow, overflow,
+/// histogram.  Integer counts are exact in double up to 2^53.
+inline void FieldStatistics::pack(std::vector<double> &buf) const {
+    buf.resize(n_header + hist_.size());
+    int i = 0;
+    buf[i++] = n_;
+    buf[i++] = mean_;
+    buf[i++] = m2_;
+    buf[i++] = min_;
+    buf[i++] = max_;
+    foralldir(d) buf[i++] = minloc_[d];
+    foralldir(d) buf[i++] = maxloc_[d];
+    buf[i++] = underflow_;
+    buf[i++] = overflow_;
+    for (auto h : hist_)
+        buf[i++] = h;
+}
+
+inline void FieldStatistics::unpack(const double *buf, int len) {
+    int i = 0;
+    n_ = buf[i++];
+    mean_ = buf[i++];
+    m2_ = buf[i++];
+    min_ = buf[i++];
+    max_ = buf[i++];
+    foralldir(d) minloc_[d] = buf[i++];
+    foralldir(d) maxloc_[d] = buf[i++];
+    underflow_ = buf[i++];
+    overflow_ = buf[i++];
+    hist_.resize(len - n_header);
+    for (auto &h : hist_)
+        h = buf[i++];
+}
+
+/// MPI reduction op.  One element of dtype is a whole packed record (contiguous
+/// doubles), so that MPI cannot split a record between calls
+inline void FieldStatistics::mpi_merge_op(void *in, void *inout, int *len,
+                                          MPI_Datatype *dtype) {
+    int bytes;
+    MPI_Type_size(*dtype, &bytes);
+    const int n = bytes / sizeof(double);
+    std::vector<double> buf;
+    for (int k = 0; k < *len; k++) {
+        double *pin = static_cast<double *>(in) + k * n;
+        double *pinout = static_cast<double *>(inout) + k * n;
+        FieldStatistics a, b;
+        a.unpack(pinout, n);
+        b.unpack(pin, n);
+        a.merge(b);
+        a.pack(buf);
+        std::memcpy(pinout, buf.data(), n * sizeof(double));
+    }
+}
+
+inline void FieldStatistics::allreduce() {
+    if (hila::number_of_nodes() == 1)
+        return;
+
+    static MPI_Op op = MPI_OP_NULL;
+    if (op == MPI_OP_NULL)
+        MPI_Op_create(&FieldStatistics::mpi_merge_op, 1, &op);
+
+    std::vector<double> buf;
+    pack(buf);
+
+    // the record length depends on the histogram, type is made for each call
+    MPI_Datatype record;
+    MPI_Type_contiguous(buf.size(), MPI_DOUBLE, &record);
+    MPI_Type_commit(&record);
+
+    reduction_timer.start();
+    MPI_Allreduce(MPI_IN_PLACE, buf.data(), 1, record, op, lattice.mpi_comm_lat);
+    reduction_timer.stop();
+
+    MPI_Type_free(&record);
+
+    // unpack resets histogram size, which stays the same; range is kept
+    unpack(buf.data(), buf.size());
+}
+
+} // namespace hila
+
+
+/// Single-pass statistics of the Field, see hila::FieldStatistics
+
+template <typename T>
+hila::FieldStatistics Field<T>::statistics(Parity par) const {
+    hila::FieldStatistics st;
+    return statistics_(par, st);
+}
+
+template <typename T>
+hila::FieldStatistics Field<T>::statistics(Parity par, double hist_min, double hist_max,
+                                           int nbins) const {
+    hila::FieldStatistics st(hist_min, hist_max, nbins);
+    return statistics_(par, st);
+}
+
+template <typename T>
+hila::FieldStatistics Field<T>::statistics_(Parity par, hila::FieldStatistics &st) const {
+
+    static_assert(std::is_arithmetic<T>::value,
+                  "Field .statistics() requires integer or floating point element type");
+
+#if defined(CUDA) || defined(HIP)
+
+    // On GPUs use min/max reductions and a sum reduction around a shift value.
+    // This takes more than one pass.
+    st.min_ = gpu_minmax(true, par, st.minloc_);
+    st.max_ = gpu_minmax(false, par, st.maxloc_);
+    double shift = 0.5 * (st.min_ + st.max_);
+
+    Reduction<int64_t> n = 0;
+    Reduction<double> s1 = 0, s2 = 0;
+    // histogram binning as in FieldStatistics::bin(), with plain variables for the
+    // device loop.  Index 0 is underflow, nbins + 1 overflow
+    const int nbins = st.hist_.size();
+    const double hmin = st.hist_min_;
+    const double hwidth = st.hist_max_ - st.hist_min_;
+    ReductionVector<int64_t> hist(nbins + 2, 0);
+    onsites (par) {
+        double v = (*this)[X] - shift;
+        n += 1;
+        s1 += v;
+        s2 += v * v;
+        if (nbins > 0) {
+            double x = v + shift;
+            int b = (x < hmin) ? -1 : (int)((x - hmin) * nbins / hwidth);
+            if (b > nbins)
+                b = nbins;
+            hist[b + 1] += 1;
+        }
+    }
+
+    st.n_ = n.value();
+    if (st.n_ > 0) {
+        double m = s1.value() / st.n_;
+        st.mean_ = m + shift;
+        st.m2_ = s2.value() - st.n_ * m * m;
+    }
+    if (nbins > 0) {
+        st.underflow_ = hist[0];
+        st.overflow_ = hist[nbins + 1];
+        for (int i = 0; i < nbins; i++)
+            st.hist_[i] = hist[i + 1];
+    }
+    return st;
+
+#else
+
+// explicit OpenMP parallel region as in minmax(), thread-local accumulators
+// merged at the end
+#pragma omp parallel shared(st)
+    {
+        hila::FieldStatistics st_th = st;
+
+#pragma hila novector omp_parallel_region direct_access(st_th)
+        onsites (par) {
+            st_th.add((*this)[X], X.coordinates());
+        }
+
+#pragma omp critical
+        st.merge(st_th);
+    }
+
+    st.allreduce();
+    return st;
+
+#endif
+}
+
+
+#endif
@@ -33,7 +33,8 @@ class field_storage {
     T *RESTRICT fieldbuf = nullptr;
     const unsigned *RESTRICT neighbours[NDIRS];
 
-    void allocate_field(const lattice_struct &lattice);
+    /// allocate the field buffer, returns the number of bytes allocated
+    size_t allocate_field(const lattice_struct &lattice);
     void free_field();
 
 #ifndef VECTORIZED
@@ -65,6 +66,12 @@ class field_storage {
         const vectorized_lattice_struct<hila::vector_info<T>::vector_size> *RESTRICT vlat,
         bool antiperiodic) const;
 
+    void gather_comm_lanes(
+        T *RESTRICT buffer, const lattice_struct::comm_node_struct &to_node, Direction d,
+        Parity par,
+        const vectorized_lattice_struct<hila::vector_info<T>::vector_size> *RESTRICT vlat,
+        bool antiperiodic) const;
+
     void place_recv_elements(
         const T *RESTRICT buffer, Direction d, Parity par,
         const vectorized_lattice_struct<hila::vector_info<T>::vector_size> *RESTRICT vlat) const;
@@ -97,6 +97,24 @@ class GaugeField {
         }
     }
 
+    /**
+     * @brief Set 't Hooft twisted boundary conditions to plane (d1,d2)
+     * @details The plaquettes \f$ U_{d1 d2}(x) \f$ on the corner \f$ x_{d1} = L_{d1}-1,
+     * x_{d2} = L_{d2}-1 \f$ get the center phase \f$ \exp(2\pi i k/N) \f$.  This is
+     * implemented as a hila::bc::TWISTED boundary condition of link field U[d2] in direction
+     * d1, applied in the boundary gathers, so that plaquettes, staples etc. need no
+     * special code.  Temporary fields which are gathered over the boundary must copy the
+     * boundary condition, see staplesum().
+     *
+     * Requires SPECIAL_BOUNDARY_CONDITIONS, not available on vectorized or GPU targets.
+     *
+     * @param d1, d2 twist plane
+     * @param k twist, modulo N
+     */
+    void set_twist(Direction d1, Direction d2, int k) {
+        fdir[d2].set_twisted_boundary_condition(d1, d2, expi(2 * M_PI * k / T::size()));
+    }
+
     /**
      * @brief Computes Wilson action
      * @details \f{align}{ S &=  \beta\sum_{\textbf{dir}_1 < \textbf{dir}_2}\sum_{X} \frac{1}{N}
@@ -21,6 +21,8 @@
 #include "plumbing/reduction.h"
 #include "plumbing/reductionvector.h"
 #include "plumbing/site_select.h"
+#include "plumbing/site_region.h"
+#include "plumbing/field_statistics.h"
 
 //#if defined(CUDA) || defined(HIP)
 //#include "plumbing/backend_gpu/gpu_reduction.h"
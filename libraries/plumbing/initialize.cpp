@@ -245,6 +245,10 @@ void hila::initialize(int argc, char **argv) {
     hila::out0 << "Using option OPENMP - with " << omp_get_max_threads() << " threads\n";
 #endif
 
+#if defined(THREAD_POOL)
+    hila::thread_pool::initialize();
+#endif
+
 
 #if defined(CUDA) || defined(HIP)
     hila::out0 << "Using thread blocks of size " << N_threads << " threads\n";
@@ -331,6 +335,8 @@ void hila::finishrun() {
     }
 
 
+    hila::memory_report();
+
 #if defined(CUDA) || defined(HIP)
     gpuMemPoolReport();
 #endif
@@ -347,6 +353,10 @@ void hila::finishrun() {
 
     hila::about_to_finish = true;
 
+#if defined(THREAD_POOL)
+    hila::thread_pool::finish();
+#endif
+
     finish_communications();
 
     print_dashed_line();
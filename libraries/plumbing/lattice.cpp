@@ -3,6 +3,14 @@
 #include "plumbing/lattice.h"
 #include "plumbing/field.h"
 
+#if defined(OPENMP)
+#include <omp.h>
+#endif
+
+// timers for the lattice setup phases
+hila::timer lattice_setup_timer("lattice setup");
+hila::timer std_gathers_setup_timer(" setup std gathers");
+
 // Reporting on possibly too large node: stop if
 // node size (with buffers) is larger than 2^31 - too close for comfort!
 
@@ -32,6 +40,8 @@ static int lattice_count = 0;
 /// General lattice setup
 void lattice_struct::setup(const CoordinateVector &siz) {
 
+    lattice_setup_timer.start();
+
     l_label = lattice_count++;
 
     // Add this lattice to the list
@@ -68,6 +78,8 @@ void lattice_struct::setup(const CoordinateVector &siz) {
     backend_lattice->setup(*this);
 #endif
 
+    lattice_setup_timer.stop();
+
     if (hila::check_input) {
         hila::out << "***** Input check done *****\n";
         hila::finishrun();
@@ -276,6 +288,41 @@ unsigned lattice_struct::site_index(const CoordinateVector &loc, const unsigned
 
 #endif // SUBNODE_LAYOUT
 
+///////////////////////////////////////////////////////////////////////
+/// Helpers for the (OpenMP parallel) setup loops.  Sites of the node are
+/// traversed by x-rows, walking the coordinates within a row, so that no
+/// index -> coordinate decoding is needed.
+///////////////////////////////////////////////////////////////////////
+
+/// number of x-rows on the node
+static size_t node_rows(const CoordinateVector &size) {
+    size_t n = 1;
+    for (int d = 1; d < NDIM; d++)
+        n *= size[d];
+    return n;
+}
+
+/// coordinates of the 1st site of x-row r
+static CoordinateVector row_start(size_t r, const CoordinateVector &min,
+                                  const CoordinateVector &size) {
+    CoordinateVector l;
+    l[0] = min[0];
+    for (int d = 1; d < NDIM; d++) {
+        l[d] = min[d] + r % size[d];
+        r /= size[d];
+    }
+    return l;
+}
+
+/// number of blocks in parallel loops which need ordered output
+static int setup_blocks() {
+#if defined(OPENMP)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////
 /// invert the mynode index -> location (only on this node)
 ///////////////////////////////////////////////////////////////////////
@@ -378,16 +425,15 @@ void lattice_struct::node_struct::setup(node_info &ni, lattice_struct &lattice)
     // map site indexes to locations -- coordinates array
     // after the above site_index should work
 
-#ifdef EVEN_SITES_FIRST
+#if defined(EVEN_SITES_FIRST) && !defined(COMPACT_COORDINATES)
     coordinates.resize(sites);
-    CoordinateVector l = min;
-    for (unsigned i = 0; i < sites; i++) {
-        coordinates[lattice.site_index(l)] = l;
-        // walk through the coordinates
-        foralldir(d) {
-            if (++l[d] < (min[d] + size[d]))
-                break;
-            l[d] = min[d];
+    const size_t nrows = node_rows(size);
+
+#pragma omp parallel for
+    for (size_t r = 0; r < nrows; r++) {
+        CoordinateVector l = row_start(r, min, size);
+        for (int x = 0; x < size[0]; x++, l[0]++) {
+            coordinates[lattice.site_index(l)] = l;
         }
     }
 
@@ -405,8 +451,78 @@ void lattice_struct::node_struct::setup(node_info &ni, lattice_struct &lattice)
     // set up the subnodes
     subnodes.setup(*this);
 #endif
+
+#if defined(EVEN_SITES_FIRST) && defined(COMPACT_COORDINATES)
+    // this has to be after subnodes
+    setup_compact_coordinates(lattice);
+#endif
+}
+
+#if defined(EVEN_SITES_FIRST) && defined(COMPACT_COORDINATES)
+
+////////////////////////////////////////////////////////////////////////
+/// Set up the x-row tables used by lattice_struct::coordinates().
+/// Storage is (node volume / x-size) coordinate vectors, instead of
+/// (node volume).  In SUBNODE_LAYOUT rows are for subnode 0, and the
+/// subnode origins are stored separately.
+////////////////////////////////////////////////////////////////////////
+void lattice_struct::node_struct::setup_compact_coordinates(lattice_struct &lattice) {
+
+#ifdef SUBNODE_LAYOUT
+    CoordinateVector rsize = subnodes.size;
+    row_even_sites = subnodes.evensites;
+#else
+    CoordinateVector rsize = size;
+    row_even_sites = evensites;
+#endif
+
+    row_length = rsize[0];
+    // the reciprocal 2^64 / row_length + 1 does not fit in 64 bits if row_length == 1
+    if (row_length < 2)
+        hila::error("COMPACT_COORDINATES needs node x-size > 1, is " +
+                    std::to_string(row_length));
+    row_length_inv = UINT64_MAX / row_length + 1;
+    size_t nrows = 1;
+    for (int d = 1; d < NDIM; d++)
+        nrows *= rsize[d];
+
+    row_coordinates.resize(nrows);
+    row_parity.resize(nrows);
+
+    CoordinateVector l = min;
+    for (size_t r = 0; r < nrows; r++) {
+        row_coordinates[r] = l;
+        row_parity[r] = (l.parity() == EVEN) ? 0 : 1;
+        // walk through the row starts
+        for (int d = 1; d < NDIM; d++) {
+            if (++l[d] < (min[d] + rsize[d]))
+                break;
+            l[d] = min[d];
+        }
+    }
+
+#ifdef SUBNODE_LAYOUT
+    // find the subnode labels from site_index() of the subnode origins
+    CoordinateVector n(0);
+    for (int s = 0; s < number_of_subnodes; s++) {
+        CoordinateVector offset;
+        foralldir(d) offset[d] = n[d] * rsize[d];
+
+        // all sites in a vector must have the same parity
+        assert(offset.parity() == EVEN);
+        subnode_offset[lattice.site_index(min + offset) % number_of_subnodes] = offset;
+
+        foralldir(d) {
+            if (++n[d] < subnodes.divisions[d])
+                break;
+            n[d] = 0;
+        }
+    }
+#endif
 }
 
+#endif
+
 #ifdef SUBNODE_LAYOUT
 
 ////////////////////////////////////////////////////////////////////////
@@ -421,6 +537,24 @@ void lattice_struct::node_struct::subnode_struct::setup(const node_struct &tn) {
 
 #endif
 
+/////////////////////////////////////////////////////////////////////
+/// Split mpi_comm_lat to slab and line communicators for slice reductions to d.
+/// Line communicator is ordered by the node position to d.
+const lattice_struct::slice_comm_struct &lattice_struct::get_slice_comm(Direction d) {
+
+    slice_comm_struct &sc = slice_comms[d];
+    if (!sc.is_set) {
+        // line colour: node position in other directions
+        int line_color = 0;
+        foralldir(d2) if (d2 != d) line_color = line_color * size(d2) + mynode.min[d2];
+
+        MPI_Comm_split(mpi_comm_lat, mynode.min[d], mynode.rank, &sc.slab);
+        MPI_Comm_split(mpi_comm_lat, line_color, mynode.min[d], &sc.line);
+        sc.is_set = true;
+    }
+    return sc;
+}
+
 /////////////////////////////////////////////////////////////////////
 /// Create the neighbour index arrays
 /// This is for the index array neighbours
@@ -429,6 +563,8 @@ void lattice_struct::node_struct::subnode_struct::setup(const node_struct &tn) {
 
 void lattice_struct::create_std_gathers() {
 
+    std_gathers_setup_timer.start();
+
     // allocate neighbour arrays - TODO: these should
     // be allocated on "device" memory too!
 
@@ -441,9 +577,17 @@ void lattice_struct::create_std_gathers() {
     // We set the communication and the neigbour-array here
     int too_large_node = 0;
 
+    // sites are traversed by x-rows, see row_start()
+    const size_t nrows = node_rows(mynode.size);
+
+    // off-node neighbours are flagged temporarily with these, storing the parity
+    const unsigned off_node_even = mynode.sites;
+    const unsigned off_node_odd = mynode.sites + 1;
+
     for (Direction d = e_x; d < NDIRS; ++d) {
 
         nn_comminfo[d].index = neighb[d]; // this is not really used for nn gathers
+        nn_comminfo[d].is_local = (nodes.n_divisions[abs(d)] == 1);
 
         comm_node_struct &from_node = nn_comminfo[d].from_node;
         // we can do the opposite send during another pass of the sites.
@@ -454,47 +598,58 @@ void lattice_struct::create_std_gathers() {
         from_node.rank = to_node.rank = mynode.rank; // invalidate from_node, for time being
         // if there are no communications the rank is left as is
 
-        // counters to zero
-        from_node.sites = from_node.evensites = from_node.oddsites = 0;
+        // Only coordinate ad changes in the step.  Off-node neighbours are all on node nn[d]
+        const Direction ad = abs(d);
+        const int step = is_up_dir(d) ? 1 : -1;
+        const unsigned nn_rank = mynode.nn[d];
 
         // pass over sites
-        size_t num = 0; // number of sites off node
-        for (int i = 0; i < mynode.sites; i++) {
-            CoordinateVector ln, l;
-            l = coordinates(i);
-            // set ln to be the neighbour of the site
-            // TODO: FIXED BOUNDARY CONDITIONS DO NOT WRAP
-            ln = (l + d).mod(size());
-            // ln = l;
-            // if (is_up_dir(d)) ln[d] = (l[d] + 1) % size(d);
-            // else ln[d] = (l[d] + size(-d) - 1) % size(-d);
-
-            if (is_on_mynode(ln)) {
-                neighb[d][i] = site_index(ln);
-            } else {
-                // reset neighb array temporarily, as a flag
-                neighb[d][i] = mynode.sites;
-
-                // Now site is off-node, this leads to gathering
-                // check that there's really only 1 node to talk with
-                unsigned rank = node_rank(ln);
-                if (from_node.rank == mynode.rank) {
-                    from_node.rank = rank;
-                } else if (from_node.rank != rank) {
-                    hila::out << "Internal error in nn-communication setup\n";
-                    exit(1);
-                }
-
-                from_node.sites++;
-                if (l.parity() == EVEN)
-                    from_node.evensites++;
-                else
-                    from_node.oddsites++;
+        size_t n_even = 0, n_odd = 0; // number of sites off node
+        int rank_error = 0;
+
+#pragma omp parallel for reduction(+ : n_even, n_odd, rank_error)
+        for (size_t r = 0; r < nrows; r++) {
+            CoordinateVector l = row_start(r, mynode.min, mynode.size);
+            for (int x = 0; x < mynode.size[0]; x++, l[0]++) {
+                unsigned i = site_index(l);
+
+                // set ln to be the neighbour of the site
+                // TODO: FIXED BOUNDARY CONDITIONS DO NOT WRAP
+                CoordinateVector ln = l;
+                ln[ad] = pmod(l[ad] + step, size(ad));
+
+                if (ln[ad] >= mynode.min[ad] && ln[ad] < mynode.min[ad] + mynode.size[ad]) {
+                    neighb[d][i] = site_index(ln);
+                } else {
+                    // Now site is off-node, this leads to gathering
+                    // check that there's really only 1 node to talk with
+                    if ((unsigned)node_rank(ln) != nn_rank)
+                        rank_error++;
 
-                num++;
+                    if (l.parity() == EVEN) {
+                        neighb[d][i] = off_node_even;
+                        n_even++;
+                    } else {
+                        neighb[d][i] = off_node_odd;
+                        n_odd++;
+                    }
+                }
             }
         }
 
+        if (rank_error > 0) {
+            hila::out << "Internal error in nn-communication setup\n";
+            exit(1);
+        }
+
+        size_t num = n_even + n_odd;
+        if (num > 0)
+            from_node.rank = nn_rank;
+
+        from_node.sites = num;
+        from_node.evensites = n_even;
+        from_node.oddsites = n_odd;
+
         // and set buffer indices
         from_node.buffer = c_offset;
 
@@ -518,22 +673,45 @@ void lattice_struct::create_std_gathers() {
 
         if (num > 0) {
             // set the remaining neighbour array indices and sitelists in another go
-            // over sites. temp counters NOTE: ordering is automatically right: with a
+            // over sites. NOTE: ordering must be in ascending site index: with a
             // given parity, neighbour node indices come in ascending order of host node
-            // index - no sorting needed
-            size_t c_even, c_odd;
-            c_even = c_odd = 0;
+            // index - no sorting needed.
+            // Parallelize over blocks of sites: count off-node sites in each block,
+            // and the starting counters of the blocks are the prefix sums of these.
+
+            const int nblocks = setup_blocks();
+            const size_t bsize = (mynode.sites + nblocks - 1) / nblocks;
+            std::vector<size_t> b_even(nblocks + 1, 0), b_odd(nblocks + 1, 0);
+
+#pragma omp parallel for
+            for (int b = 0; b < nblocks; b++) {
+                size_t ne = 0, no = 0;
+                size_t iend = std::min(mynode.sites, (b + 1) * bsize);
+                for (size_t i = b * bsize; i < iend; i++) {
+                    if (neighb[d][i] == off_node_even)
+                        ne++;
+                    else if (neighb[d][i] == off_node_odd)
+                        no++;
+                }
+                b_even[b + 1] = ne;
+                b_odd[b + 1] = no;
+            }
+
+            for (int b = 0; b < nblocks; b++) {
+                b_even[b + 1] += b_even[b];
+                b_odd[b + 1] += b_odd[b];
+            }
 
-            for (size_t i = 0; i < mynode.sites; i++) {
-                if (neighb[d][i] == mynode.sites) {
-                    CoordinateVector l;
-                    l = coordinates(i);
+#pragma omp parallel for
+            for (int b = 0; b < nblocks; b++) {
+                size_t c_even = b_even[b];
+                size_t c_odd = b_odd[b];
+                size_t iend = std::min(mynode.sites, (b + 1) * bsize);
 
-                    if (l.parity() == EVEN) {
+                for (size_t i = b * bsize; i < iend; i++) {
+                    if (neighb[d][i] == off_node_even) {
                         // THIS site is even
                         neighb[d][i] = c_offset + c_even;
-                        if (c_offset + c_even >= (1ULL << 32))
-                            too_large_node = 1;
 
 #ifndef VANILLA
                         from_node.sitelist[c_even] = i;
@@ -544,10 +722,8 @@ void lattice_struct::create_std_gathers() {
 
                         c_even++;
 
-                    } else {
+                    } else if (neighb[d][i] == off_node_odd) {
                         neighb[d][i] = c_offset + from_node.evensites + c_odd;
-                        if (c_offset + from_node.evensites + c_odd >= (1ULL << 32))
-                            too_large_node = 1;
 
 #ifndef VANILLA
                         from_node.sitelist[c_odd + from_node.evensites] = i;
@@ -564,6 +740,7 @@ void lattice_struct::create_std_gathers() {
 
         c_offset += from_node.sites;
 
+        // this checks also the neighbour indices set above
         if (c_offset >= (1ULL << 32))
             too_large_node = 1;
 
@@ -572,6 +749,8 @@ void lattice_struct::create_std_gathers() {
     /* Finally, set the site to the final offset (better be right!) */
     mynode.field_alloc_size = c_offset;
 
+    std_gathers_setup_timer.stop();
+
     if (hila::reduce_node_sum(too_large_node) > 0) {
         report_too_large_node();
     }
@@ -599,6 +778,7 @@ void lattice_struct::initialize_wait_arrays() {
 
     wait_arr_ = (dir_mask_t *)memalloc(mynode.sites * sizeof(unsigned char));
 
+#pragma omp parallel for
     for (size_t i = 0; i < mynode.sites; i++) {
         wait_arr_[i] = 0; /* basic, no wait */
         foralldir(dir) {
@@ -644,15 +824,30 @@ void lattice_struct::init_special_boundaries() {
                 special_boundaries[d].is_needed = true;
                 special_boundaries[d].offset = mynode.field_alloc_size;
 
-                for (unsigned i = 0; i < mynode.sites; i++)
-                    if (coordinate(i, abs(d)) == coord) {
-                        // set buffer indices
-                        special_boundaries[d].n_total++;
-                        if (site_parity(i) == EVEN)
-                            special_boundaries[d].n_even++;
+                // the boundary is the whole node plane coordinate(abs(d)) == coord,
+                // count its sites by rows
+                const Direction ad = abs(d);
+                const size_t nrows = node_rows(mynode.size);
+                size_t n_even = 0, n_odd = 0;
+
+#pragma omp parallel for reduction(+ : n_even, n_odd)
+                for (size_t r = 0; r < nrows; r++) {
+                    CoordinateVector l = row_start(r, mynode.min, mynode.size);
+                    if (ad != e_x && l[ad] != coord)
+                        continue;
+                    for (int x = 0; x < mynode.size[0]; x++) {
+                        l[e_x] = mynode.min[e_x] + x;
+                        if (l[ad] != coord)
+                            continue;
+                        if (l.parity() == EVEN)
+                            n_even++;
                         else
-                            special_boundaries[d].n_odd++;
+                            n_odd++;
                     }
+                }
+                special_boundaries[d].n_even = n_even;
+                special_boundaries[d].n_odd = n_odd;
+                special_boundaries[d].n_total = n_even + n_odd;
                 mynode.field_alloc_size += special_boundaries[d].n_total;
             }
         }
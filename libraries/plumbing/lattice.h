@@ -27,8 +27,10 @@ constexpr unsigned number_of_subnodes = VECTOR_SIZE / sizeof(float);
 #endif
 
 namespace hila {
-/// list of field boundary conditions - used only if SPECIAL_BOUNDARY_CONDITIONS defined
-enum class bc { PERIODIC, ANTIPERIODIC, DIRICHLET };
+/// list of field boundary conditions - used only if SPECIAL_BOUNDARY_CONDITIONS defined.
+/// TWISTED multiplies the elements gathered over the boundary with a phase on the last
+/// layer of a second direction, see Field::set_twisted_boundary_condition()
+enum class bc { PERIODIC, ANTIPERIODIC, DIRICHLET, TWISTED };
 
 /// False if we have b.c. which does not require communication
 inline bool bc_need_communication(hila::bc bc) {
@@ -78,7 +80,22 @@ class lattice_struct {
         bool first_site_even;       // is location min even or odd?
 
 #ifdef EVEN_SITES_FIRST
+#ifndef COMPACT_COORDINATES
         std::vector<CoordinateVector> coordinates;
+#else
+        /// Compact coordinate tables: coordinates and parity (0 even, 1 odd) of the first
+        /// site of each x-row of the node (of subnode 0 in SUBNODE_LAYOUT).
+        /// See lattice_struct::coordinates()
+        std::vector<CoordinateVector> row_coordinates;
+        std::vector<unsigned char> row_parity;
+        unsigned row_length;      // x-size of the (sub)node
+        uint64_t row_length_inv;  // 2^64 / row_length + 1, for fast division
+        unsigned row_even_sites;  // even sites on the (sub)node
+#ifdef SUBNODE_LAYOUT
+        CoordinateVector subnode_offset[number_of_subnodes]; // origin of subnode wrt. mynode.min
+#endif
+        void setup_compact_coordinates(lattice_struct &lattice);
+#endif
 #endif
 
         Vector<NDIM, unsigned> size_factor; // components: 1, size[0], size[0]*size[1], ...
@@ -186,6 +203,8 @@ class lattice_struct {
         unsigned *index;
         comm_node_struct from_node, to_node;
         unsigned receive_buf_size; // only for general gathers
+        // direction not divided between nodes: neighbours wrap around on this node
+        bool is_local;
     };
 
     /// general communication
@@ -300,6 +319,8 @@ class lattice_struct {
         }
     }
 
+#ifndef COMPACT_COORDINATES
+
     inline const CoordinateVector &coordinates(unsigned idx) const {
         return mynode.coordinates[idx];
     }
@@ -308,6 +329,61 @@ class lattice_struct {
         return mynode.coordinates[idx][d];
     }
 
+#else
+
+    // Compact coordinates: within a parity the site index is i/2, where i is the
+    // "typewriter" index of the site on the (sub)node.  Thus i = 2*j or 2*j+1, and the
+    // right one is found from the parity of the x-row start.
+
+    inline void compact_row_and_x(unsigned idx, unsigned &row, unsigned &x) const {
+#ifdef SUBNODE_LAYOUT
+        idx /= number_of_subnodes;
+#endif
+        unsigned par = 0;
+        if (idx >= mynode.row_even_sites) {
+            idx -= mynode.row_even_sites;
+            par = 1;
+        }
+        unsigned i = 2 * idx;
+        // row = i / row_length, with 64x32 multiply-high (exact for 32-bit i), without
+        // 128-bit integers: the low word contributes only through its carry
+        uint64_t m_lo = mynode.row_length_inv & 0xffffffffu;
+        uint64_t m_hi = mynode.row_length_inv >> 32;
+        row = (m_hi * i + ((m_lo * i) >> 32)) >> 32;
+        x = i - row * mynode.row_length;
+        // step to i+1 if parity does not match, possibly to the next row if row length is odd
+        x += mynode.row_parity[row] ^ (x & 1) ^ par;
+        if (x == mynode.row_length) {
+            x = 0;
+            row++;
+        }
+    }
+
+    inline const CoordinateVector coordinates(unsigned idx) const {
+        unsigned row, x;
+        compact_row_and_x(idx, row, x);
+        CoordinateVector c = mynode.row_coordinates[row];
+        c[0] += x;
+#ifdef SUBNODE_LAYOUT
+        c += mynode.subnode_offset[idx % number_of_subnodes];
+#endif
+        return c;
+    }
+
+    inline int coordinate(unsigned idx, Direction d) const {
+        unsigned row, x;
+        compact_row_and_x(idx, row, x);
+        int c = mynode.row_coordinates[row][d];
+        if (d == e_x)
+            c += x;
+#ifdef SUBNODE_LAYOUT
+        c += mynode.subnode_offset[idx % number_of_subnodes][d];
+#endif
+        return c;
+    }
+
+#endif // COMPACT_COORDINATES
+
     inline Parity site_parity(unsigned idx) const {
         if (idx < mynode.evensites)
             return EVEN;
@@ -369,6 +445,17 @@ class lattice_struct {
 
     MPI_Comm mpi_comm_lat;
 
+    /// Communicators for slice (profile) reductions to direction d: "slab" contains the
+    /// nodes with the same coordinate range to d, "line" one node from each slab.
+    /// Created on first use
+    struct slice_comm_struct {
+        MPI_Comm slab, line;
+        bool is_set = false;
+    };
+    std::array<slice_comm_struct, NDIM> slice_comms;
+
+    const slice_comm_struct &get_slice_comm(Direction d);
+
     // Guarantee 64 bits for these - 32 can overflow!
     int64_t n_gather_done = 0, n_gather_avoided = 0;
 
@@ -86,3 +86,113 @@ void d_free(void *dptr) {
 #endif
 
 }
+
+
+/////////////////////////////////////////////////////////////////////////
+// Memory accounting
+/////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <vector>
+#include <iomanip>
+#include "plumbing/com_mpi.h"
+
+namespace hila {
+
+struct memory_record {
+    int64_t live = 0, peak = 0, n_alloc = 0;
+};
+
+static std::map<std::string, memory_record> memory_records;
+static int64_t memory_live_bytes = 0, memory_peak_bytes = 0;
+
+void memory_allocated(const std::string &key, size_t bytes) {
+    memory_record &r = memory_records[key];
+    r.live += bytes;
+    r.peak = std::max(r.peak, r.live);
+    r.n_alloc++;
+    memory_live_bytes += bytes;
+    memory_peak_bytes = std::max(memory_peak_bytes, memory_live_bytes);
+}
+
+void memory_freed(const std::string &key, size_t bytes) {
+    memory_records[key].live -= bytes;
+    memory_live_bytes -= bytes;
+}
+
+int64_t memory_in_use() {
+    return memory_live_bytes;
+}
+
+int64_t memory_peak() {
+    return memory_peak_bytes;
+}
+
+std::string type_name_from_signature(const char *signature) {
+    std::string s(signature);
+    size_t b = s.find("T = ");
+    if (b == std::string::npos)
+        return s;
+    b += 4;
+    // gcc lists further substitutions after ';', the type itself can contain ']'
+    size_t e = s.find(';', b);
+    if (e == std::string::npos)
+        e = s.rfind(']');
+    if (e == std::string::npos || e < b)
+        e = s.size();
+    return s.substr(b, e - b);
+}
+
+void memory_report() {
+
+    // Fields are allocated collectively, use the keys of rank 0
+    std::vector<std::string> keys;
+    if (hila::myrank() == 0) {
+        for (auto &r : memory_records)
+            keys.push_back(r.first);
+    }
+    hila::broadcast(keys);
+
+    // live, peak and allocation count for each key, and totals
+    std::vector<int64_t> v(3 * keys.size() + 2, 0);
+    for (size_t i = 0; i < keys.size(); i++) {
+        auto it = memory_records.find(keys[i]);
+        if (it != memory_records.end()) {
+            v[3 * i] = it->second.live;
+            v[3 * i + 1] = it->second.peak;
+            v[3 * i + 2] = it->second.n_alloc;
+        }
+    }
+    v[3 * keys.size()] = memory_live_bytes;
+    v[3 * keys.size() + 1] = memory_peak_bytes;
+
+    if (hila::number_of_nodes() > 1)
+        MPI_Allreduce(MPI_IN_PLACE, v.data(), v.size(), MPI_INT64_T, MPI_MAX,
+                      lattice.mpi_comm_lat);
+
+    if (hila::myrank() == 0) {
+        constexpr double MB = 1024.0 * 1024.0;
+        hila::out << std::left << std::setw(34) << "MEMORY REPORT (MB, max over ranks)"
+                  << std::right << std::setw(10) << "live" << std::setw(12) << "peak"
+                  << std::setw(12) << "allocs" << '\n';
+        hila::out << "------------------------------------------------------------"
+                     "---------------\n";
+        hila::out << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < keys.size(); i++) {
+            std::string name = keys[i];
+            if (name.size() > 34)
+                name = name.substr(0, 31) + "...";
+            hila::out << std::left << std::setw(34) << name << std::right << std::setw(10)
+                      << v[3 * i] / MB << std::setw(12) << v[3 * i + 1] / MB << std::setw(12)
+                      << v[3 * i + 2] << '\n';
+        }
+        hila::out << "------------------------------------------------------------"
+                     "---------------\n";
+        hila::out << std::left << std::setw(34) << "Total" << std::right << std::setw(10)
+                  << v[3 * keys.size()] / MB << std::setw(12) << v[3 * keys.size() + 1] / MB
+                  << '\n';
+        hila::out << std::defaultfloat << std::setprecision(6);
+    }
+}
+
+} // namespace hila
@@ -1,7 +1,12 @@
+#ifndef MEMALLOC_H_
+#define MEMALLOC_H_
+
 /// Memory allocator -- gives back aligned memory, if ALIGN defined
 
 #include "plumbing/defs.h"
 
+#include <string>
+
 /// We'll have two prototypes, 2nd gives the file name and size for error messages
 /// preprocessor substitutes memalloc() -calls with right parameters!
 
@@ -16,3 +21,38 @@ void *memalloc(std::size_t size, const char *filename, const unsigned line);
 /// depending on the target.  Free with d_free()
 void *d_malloc(std::size_t size);
 void d_free(void * dptr);
+
+
+namespace hila {
+
+/// Memory accounting.  Field payloads and MPI buffers are recorded here, keyed by
+/// element type, with live and peak bytes and allocation counts:
+///
+///   hila::memory_report();      // collective, max over ranks
+///
+/// The report is printed also in hila::finishrun().
+
+void memory_allocated(const std::string &key, size_t bytes);
+void memory_freed(const std::string &key, size_t bytes);
+
+/// Bytes in use and peak on this rank
+int64_t memory_in_use();
+int64_t memory_peak();
+
+/// Print the memory usage table, maximum over ranks.  Must be called by all ranks
+void memory_report();
+
+/// Type name from the __PRETTY_FUNCTION__ string of a function template with
+/// parameter T, "... [with T = name; ...]" (gcc) or "... [T = name]" (clang)
+std::string type_name_from_signature(const char *signature);
+
+/// Readable name of type T, for memory accounting keys.  Does not need RTTI
+template <typename T>
+const std::string &type_name() {
+    static const std::string name = type_name_from_signature(__PRETTY_FUNCTION__);
+    return name;
+}
+
+} // namespace hila
+
+#endif
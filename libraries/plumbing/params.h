@@ -49,6 +49,21 @@
 #undef EVEN_SITES_FIRST
 #endif
 
+/**
+ * @brief COMPACT_COORDINATES: compute site coordinates instead of storing them
+ * @details With EVEN_SITES_FIRST the coordinates of the sites are by default kept in a table of
+ * (node volume) CoordinateVectors, read by X.coordinates() and X.coordinate(d) in site loops.
+ * With -DCOMPACT_COORDINATES (make option COMPACT_COORDINATES=1) only the coordinates of the
+ * first site of each x-row are stored and the rest are computed from the site index.  This
+ * reduces the table size by the x-size of the node at the cost of a few integer ops per call.
+ * Without EVEN_SITES_FIRST coordinates are always computed, and this has no effect.
+ */
+#ifdef COMPACT_COORDINATES
+#if COMPACT_COORDINATES == 0 || !defined(EVEN_SITES_FIRST)
+#undef COMPACT_COORDINATES
+#endif
+#endif
+
 /// NODE_LAYOUT_TRIVIAL or NODE_LAYOUT_BLOCK determine how MPI ranks are laid out on logical
 /// lattice.  TRIVIAL lays out the lattice on logical order where x-direction runs fastest etc.
 /// if NODE_LAYOUT_BLOCK is defined, NODE_LAYOUT_BLOCK consecutive MPI ranks are laid out so that
@@ -82,6 +82,17 @@ double gaussrand();
 #pragma hila contains_rng loop_function
 double gaussrand2(double &out2);
 
+/**
+ *@brief `hila::gaussrand_array` fills array out with n Gaussian random numbers with variance
+ * \f$width^2\f$.
+ *@details Batched Box-Muller: the uniform random numbers are drawn first, in the same order as
+ * in repeated gaussrand2() calls, and the log/sqrt/sincos are then evaluated for the whole batch,
+ * with vectorclass SIMD functions in AVX builds.  Used to fill whole matrices and algebra vectors
+ * at once.  If n is odd, one number is discarded.  Not available on GPU.
+ */
+#pragma hila contains_rng loop_function
+void gaussrand_array(double *out, size_t n, double width = 1.0);
+
 /**
  *@brief Check if RNG is initialized, do what the name says.
  */  
@@ -60,6 +60,33 @@ inline auto norm(T val) {
 
 namespace hila {
 
+// Lane-wise helpers for branch-free code which is instantiated both with scalar types and,
+// in vectorized loops, with SIMD vector types.  For scalars the mask type is bool; the
+// vector overloads are in backend_vector/defs.h.
+
+/// type of the result of comparisons of R, e.g. bool for double
+template <typename R>
+using lane_mask = decltype(std::declval<R>() < std::declval<R>());
+
+/// scalar type of the lanes of R, R itself for scalar types
+#if defined(VECTORIZED)
+template <typename R>
+using lane_scalar_type = typename avx_vector_type_info<R>::type;
+#else
+template <typename R>
+using lane_scalar_type = R;
+#endif
+
+/// lane_select(mask, a, b): a where mask is set, otherwise b
+template <typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+inline T lane_select(bool mask, T a, T b) {
+    return mask ? a : b;
+}
+
+/// true if mask is set on all lanes
+inline bool all_lanes(bool mask) {
+    return mask;
+}
 
 /// convert to string: separator does nothing, but for compatibility w. other to_strings
 
@@ -325,6 +325,91 @@ T Field<T>::product(Parity par, bool allreduce) const {
 #include "backend_gpu/gpu_reduction.h"
 #endif
 
+namespace hila {
+
+/// Combine node-local slice sums (lattice.mynode.size[dir] elements) to the full
+/// profile along dir on all ranks.  The slab of nodes sharing the same coordinate
+/// range is summed, and the slabs are gathered along dir.
+template <typename T>
+std::vector<T> slice_reduce(std::vector<T> &local, Direction dir) {
+
+    const int nloc = lattice.mynode.size[dir];
+    assert(local.size() == nloc && "slice_reduce: wrong size of local vector");
+
+    if (hila::number_of_nodes() == 1)
+        return local;
+
+    reduction_timer.start();
+
+    const auto &sc = lattice.get_slice_comm(dir);
+
+    int ndiv = lattice.nodes.n_divisions[dir];
+    if (ndiv < hila::number_of_nodes()) {
+        MPI_Datatype dtype = get_MPI_number_type<T>();
+        assert(dtype != MPI_BYTE && "Unknown number_type in slice_reduce");
+        MPI_Allreduce(MPI_IN_PLACE, local.data(),
+                      nloc * (sizeof(T) / sizeof(hila::arithmetic_type<T>)), dtype, MPI_SUM,
+                      sc.slab);
+    }
+
+    std::vector<T> res;
+    if (ndiv > 1) {
+        res.resize(lattice.size(dir));
+        std::vector<int> counts(ndiv), displs(ndiv);
+        for (int i = 0; i < ndiv; i++) {
+            displs[i] = lattice.nodes.divisors[dir][i] * sizeof(T);
+            counts[i] = (lattice.nodes.divisors[dir][i + 1] - lattice.nodes.divisors[dir][i]) *
+                        sizeof(T);
+        }
+        MPI_Allgatherv(local.data(), nloc * sizeof(T), MPI_BYTE, res.data(), counts.data(),
+                       displs.data(), MPI_BYTE, sc.line);
+    } else {
+        res = local;
+    }
+
+    reduction_timer.stop();
+    return res;
+}
+
+} // namespace hila
+
+// Sum over slices orthogonal to dir.  On CPU each thread accumulates to a buffer of
+// the node-local extent, and the threads and nodes are combined with slice_reduce().
+
+template <typename T>
+std::vector<T> Field<T>::slice_sum(Direction dir, Parity par) const {
+
+#if defined(CUDA) || defined(HIP)
+    ReductionVector<T> rv(lattice.size(dir));
+    onsites (par) {
+        rv[X.coordinate(dir)] += (*this)[X];
+    }
+    return rv.vector();
+#else
+
+    const int nloc = lattice.mynode.size[dir];
+    const int cmin = lattice.mynode.min[dir];
+    std::vector<T> local(nloc, (T)0);
+
+#pragma omp parallel shared(local)
+    {
+        std::vector<T> local_th(nloc, (T)0);
+
+#pragma hila novector omp_parallel_region direct_access(local_th)
+        onsites (par) {
+            local_th[X.coordinate(dir) - cmin] += (*this)[X];
+        }
+
+#pragma omp critical
+        for (int i = 0; i < nloc; i++)
+            local[i] += local_th[i];
+    }
+
+    return hila::slice_reduce(local, dir);
+#endif
+}
+
+
 template <typename T>
 T Field<T>::minmax(bool is_min, Parity par, CoordinateVector &loc) const {
 
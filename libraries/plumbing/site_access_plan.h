@@ -0,0 +1,115 @@
+#ifndef SITE_ACCESS_PLAN_H_
+#define SITE_ACCESS_PLAN_H_
+
+#include <vector>
+#include <algorithm>
+
+#include "plumbing/defs.h"
+#include "plumbing/coordinates.h"
+#include "plumbing/lattice.h"
+
+/**
+ * @brief Precomputed access plan for a fixed list of lattice sites
+ *
+ * @details Maps a list of coordinates to node ranks and local site indices once, so
+ * that repeated Field::get_elements(), set_elements() and add_elements() calls on the
+ * same set of sites (correlator sources, walls, surfaces...) do not need to recompute
+ * them.  The plan does not depend on the Field type, and can be used with any Field.
+ *
+ *   SiteAccessPlan plan(coord_list);
+ *   auto v = f.get_elements(plan);        // to rank 0
+ *   auto w = g.get_elements(plan, true);  // to all ranks, allgather
+ *   h.add_elements(w, plan);               // h[coord_list[i]] += w[i]
+ *
+ * The coordinate list must be the same on all ranks.
+ */
+
+class SiteAccessPlan {
+
+  private:
+    size_t n = 0;
+
+    // number of sites on each rank, and the offset of the rank in rank-ordered buffer
+    std::vector<int> sites_on_rank;
+    std::vector<int> rank_offset;
+
+    // element i of the coordinate list is element order[i] in rank-ordered buffer
+    std::vector<unsigned> order;
+
+    // local site indices of the sites on this node, in coordinate list order,
+    // and their positions in the coordinate list
+    std::vector<unsigned> local_index;
+    std::vector<size_t> local_pos;
+
+    // unique local sites, and the slot in unique_index for each local_index entry.
+    // Needed for add_elements() with repeated coordinates
+    std::vector<unsigned> unique_index;
+    std::vector<unsigned> unique_slot;
+
+    template <typename T>
+    friend class Field;
+
+  public:
+    SiteAccessPlan() = default;
+
+    explicit SiteAccessPlan(const std::vector<CoordinateVector> &coord_list) {
+        setup(coord_list);
+    }
+
+    void setup(const std::vector<CoordinateVector> &coord_list) {
+        n = coord_list.size();
+        int nn = lattice.n_nodes();
+
+        sites_on_rank.assign(nn, 0);
+        rank_offset.resize(nn);
+        order.resize(n);
+        local_index.clear();
+        local_pos.clear();
+
+        std::vector<int> rank_of(n);
+        for (size_t i = 0; i < n; i++) {
+            int rank = lattice.node_rank(coord_list[i]);
+            if (rank == hila::myrank()) {
+                local_index.push_back(lattice.site_index(coord_list[i]));
+                local_pos.push_back(i);
+            }
+            rank_of[i] = rank;
+            sites_on_rank[rank]++;
+        }
+
+        rank_offset[0] = 0;
+        for (int r = 1; r < nn; r++)
+            rank_offset[r] = rank_offset[r - 1] + sites_on_rank[r - 1];
+
+        // within a rank the elements come in coordinate list order
+        std::vector<int> count(nn, 0);
+        for (size_t i = 0; i < n; i++) {
+            int r = rank_of[i];
+            order[i] = rank_offset[r] + count[r]++;
+        }
+
+        // dedup local sites for add_elements
+        unique_index = local_index;
+        std::sort(unique_index.begin(), unique_index.end());
+        unique_index.erase(std::unique(unique_index.begin(), unique_index.end()),
+                           unique_index.end());
+        unique_slot.resize(local_index.size());
+        for (size_t k = 0; k < local_index.size(); k++) {
+            unique_slot[k] = std::lower_bound(unique_index.begin(), unique_index.end(),
+                                              local_index[k]) -
+                             unique_index.begin();
+        }
+    }
+
+    /// Number of sites in the plan
+    size_t size() const {
+        return n;
+    }
+
+    /// Number of sites on this node
+    size_t local_size() const {
+        return local_index.size();
+    }
+};
+
+#endif
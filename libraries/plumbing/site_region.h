@@ -0,0 +1,128 @@
+#ifndef SITE_REGION_H_
+#define SITE_REGION_H_
+
+#include <vector>
+#include <algorithm>
+
+#include "plumbing/defs.h"
+#include "plumbing/coordinates.h"
+#include "plumbing/lattice.h"
+
+/**
+ * @brief Restricted set of lattice sites for site loops
+ *
+ * @details A SiteRegion holds the node-local site indices of a hyperplane, a box or an
+ * arbitrary list of coordinates.  Used as the argument of onsites(), the loop visits
+ * only the sites in the region, instead of filtering a full lattice loop:
+ *
+ *   onsites(SiteRegion::plane(e_t, 0)) {
+ *       ploop += trace(polyakov[X]);
+ *   }
+ *
+ *   SiteRegion wall = SiteRegion::box(cmin, cmax);   // can be reused
+ *   onsites(wall) f[X] = 0;
+ *
+ * The loop parity is EVEN or ODD if all sites of the region have that parity (a single
+ * site box, or a coordinate list), ALL otherwise.  It is found without communication.
+ * Gathers are done for the full loop parity, and written fields have their gathers
+ * invalidated for the full parity, because halo sites are not tracked per region.  A
+ * region loop does not mark the written field assigned (-check-init), so initialize the
+ * field before writing to a region of it.  Region loops are not vectorized, and are not
+ * available on GPU targets.
+ *
+ * Constructing a region goes through the lattice sites it covers; construct regions
+ * used repeatedly once, outside the loop.
+ */
+
+class SiteRegion {
+
+  private:
+    // local site indices, ascending
+    std::vector<unsigned> sites;
+    Parity par = ALL;
+
+    // sort the local sites, remove duplicates
+    void finalize() {
+        std::sort(sites.begin(), sites.end());
+        sites.erase(std::unique(sites.begin(), sites.end()), sites.end());
+    }
+
+    // add the local sites of box [cmin, cmax]
+    void add_box(const CoordinateVector &cmin, const CoordinateVector &cmax) {
+        CoordinateVector lo, hi, c;
+        foralldir(d) {
+            lo[d] = std::max(cmin[d], lattice.mynode.min[d]);
+            hi[d] = std::min(cmax[d], lattice.mynode.min[d] + lattice.mynode.size[d] - 1);
+            if (lo[d] > hi[d])
+                return;
+        }
+        forcoordinaterange(c, lo, hi) {
+            sites.push_back(lattice.site_index(c));
+        }
+    }
+
+  public:
+    SiteRegion() = default;
+
+    /// Region from a list of coordinates, same on all ranks
+    explicit SiteRegion(const std::vector<CoordinateVector> &coord_list) {
+        // the list is global, so the parity is found without communication
+        // bit 1: even sites, bit 2: odd sites
+        int mask = 0;
+        for (const CoordinateVector &c : coord_list) {
+            mask |= (c.parity() == EVEN) ? 1 : 2;
+            if (lattice.is_on_mynode(c))
+                sites.push_back(lattice.site_index(c));
+        }
+        finalize();
+
+        if (mask == 1)
+            par = EVEN;
+        else if (mask == 2)
+            par = ODD;
+    }
+
+    /// Box cmin <= x <= cmax (no wrap-around)
+    static SiteRegion box(const CoordinateVector &cmin, const CoordinateVector &cmax) {
+        SiteRegion r;
+        r.add_box(cmin, cmax);
+        r.finalize();
+
+        // a box of more than one site contains both parities
+        if (cmin == cmax)
+            r.par = cmin.parity();
+        return r;
+    }
+
+    /// Hyperplane x[dir] == coord
+    static SiteRegion plane(Direction dir, int coord) {
+        CoordinateVector cmin, cmax;
+        foralldir(d) {
+            cmin[d] = 0;
+            cmax[d] = lattice.size(d) - 1;
+        }
+        cmin[dir] = cmax[dir] = coord;
+        return box(cmin, cmax);
+    }
+
+    /// Number of sites on this node
+    size_t size() const {
+        return sites.size();
+    }
+
+    /// Site index of i:th local site of the region
+    unsigned site_index(size_t i) const {
+        return sites[i];
+    }
+
+    Parity parity() const {
+        return par;
+    }
+
+    /// Allows onsites(region) in the source; hilapp generates the region loop
+    operator Parity() const {
+        return par;
+    }
+};
+
+#endif
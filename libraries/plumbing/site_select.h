@@ -19,6 +19,10 @@ namespace gpucub = hipcub;
 
 #include "hila.h"
 
+#if defined(OPENMP)
+#include <omp.h>
+#endif
+
 
 //////////////////////////////////////////////////////////////////////////////////
 /// Site selection: special vector to accumulate chosen sites or sites + variable
@@ -34,7 +38,11 @@ namespace gpucub = hipcub;
 ///           sv.select(X, A[X]);
 ///   }
 ///
-///
+/// On CPU the selections are flagged per site in the loop, and compacted in site index
+/// order after the loop with a count + prefix sum pass, which is safe with OpenMP threads.
+/// By default the selection is joined to rank 0 after the loop.  With .no_join() the
+/// results stay distributed: each rank holds its own sites, global_size() and
+/// global_offset() give the total and the position of the rank's sites in the joined order.
 ///
 
 // just an empty class used to flag select operations
@@ -57,6 +65,63 @@ class SiteSelect {
     size_t previous_site = SIZE_MAX;
     size_t n_overflow = 0;
 
+#if !(defined(CUDA) || defined(HIP)) || defined(HILAPP)
+    // per-site selection flags (indexed by loop site index), and the
+    // selection counts of thread blocks after prefix sum
+    std::vector<unsigned char> selected;
+    std::vector<size_t> block_offset;
+
+    static int n_blocks() {
+#if defined(OPENMP)
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    static size_t block_start(int b, int nblocks, size_t n) {
+        return (n * b) / nblocks;
+    }
+
+    // count selected sites per block, and the prefix sum.  Returns the total count
+    size_t count_selected() {
+        int nblocks = n_blocks();
+        size_t n = selected.size();
+        block_offset.assign(nblocks + 1, 0);
+
+#pragma omp parallel for
+        for (int b = 0; b < nblocks; b++) {
+            size_t count = 0;
+            for (size_t i = block_start(b, nblocks, n); i < block_start(b + 1, nblocks, n); i++)
+                count += selected[i];
+            block_offset[b + 1] = count;
+        }
+        for (int b = 0; b < nblocks; b++)
+            block_offset[b + 1] += block_offset[b];
+
+        return block_offset[nblocks];
+    }
+
+    // compact the selected elements of v in index order, keeping at most nkeep
+    template <typename T>
+    void compact_selected(std::vector<T> &v, size_t nkeep) {
+        int nblocks = block_offset.size() - 1;
+        size_t n = selected.size();
+        std::vector<T> res(nkeep);
+
+#pragma omp parallel for
+        for (int b = 0; b < nblocks; b++) {
+            size_t k = block_offset[b];
+            for (size_t i = block_start(b, nblocks, n); i < block_start(b + 1, nblocks, n) && k < nkeep;
+                 i++) {
+                if (selected[i])
+                    res[k++] = v[i];
+            }
+        }
+        v = std::move(res);
+    }
+#endif
+
   public:
     /// Initialize to zero by default (? exception to other variables)
     /// allreduce = true by default
@@ -81,15 +146,11 @@ class SiteSelect {
         // filled in by hilapp
     }
 
-    // this makes sense only for cpu targets
-    void select_site(const SiteIndex s) {
-        if (s.value == previous_site) {
-            sites[current_index - 1] = s;
-        } else {
-            sites[current_index] = s;
-            previous_site = s.value;
-            current_index++;
-        }
+    // this makes sense only for cpu targets.  idx is the loop site index, so that
+    // threads write to separate slots
+    void select_site(const SiteIndex s, const unsigned idx) {
+        sites[idx] = s;
+        selected[idx] = 1;
     }
 
     SiteSelect &no_join() {
@@ -104,6 +165,9 @@ class SiteSelect {
 
     void setup() {
         sites.resize(lattice.mynode.volume());
+#if !(defined(CUDA) || defined(HIP)) || defined(HILAPP)
+        selected.assign(lattice.mynode.volume(), 0);
+#endif
         current_index = 0;
         previous_site = SIZE_MAX;
         n_overflow = 0;
@@ -205,15 +269,35 @@ class SiteSelect {
         return n_overflow;
     }
 
+    /// Total number of selected sites over all ranks, on all ranks.  Collective
+    size_t global_size() const {
+        size_t n = sites.size();
+        if (joined)
+            hila::broadcast(n);
+        else
+            hila::reduce_node_sum(&n, 1, true);
+        return n;
+    }
+
+    /// Position of the sites of this rank in the joined order.  Collective
+    size_t global_offset() const {
+        if (joined)
+            return 0;
+        size_t n = sites.size(), offset = 0;
+        MPI_Exscan(&n, &offset, 1, MPI_UINT64_T, MPI_SUM, lattice.mpi_comm_lat);
+        return hila::myrank() == 0 ? 0 : offset;
+    }
+
 #if !(defined(CUDA) || defined(HIP)) || defined(HILAPP)
 
     void endloop_action() {
+        current_index = count_selected();
         if (current_index > nmax) {
             // too many elements, trunc
             n_overflow = current_index - nmax;
             current_index = nmax;
         }
-        sites.resize(current_index);
+        compact_selected(sites, current_index);
         if (auto_join)
             join();
     }
@@ -298,9 +382,9 @@ class SiteValueSelect : public SiteSelect {
         return site_value_select_type_();
     }
 
-    void select_site_value(const SiteIndex s, const T &val) {
-        values[current_index] = val;
-        SiteSelect::select_site(s);
+    void select_site_value(const SiteIndex s, const unsigned idx, const T &val) {
+        values[idx] = val;
+        SiteSelect::select_site(s, idx);
     }
 
 
@@ -320,7 +404,7 @@ class SiteValueSelect : public SiteSelect {
         bool save = auto_join;
         auto_join = false;
         SiteSelect::endloop_action();
-        values.resize(current_index);
+        compact_selected(values, current_index);
         auto_join = save;
         if (auto_join)
             join();
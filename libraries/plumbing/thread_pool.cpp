@@ -0,0 +1,253 @@
+/// Persistent thread pool for site loops, see thread_pool.h
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <sched.h>
+#include <pthread.h>
+
+#include "hila.h"
+#include "plumbing/thread_pool.h"
+
+#if defined(OPENMP)
+#include <omp.h>
+#endif
+
+namespace {
+
+/// pause instruction for spin loops
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/// how long the threads spin waiting before yielding or sleeping.  If there are more
+/// threads than cpus, spinning only delays the other threads and it is kept short
+constexpr int spin_iterations = 1 << 14;
+constexpr int spin_iterations_oversubscribed = 16;
+
+/// sense-reversing spin barrier.  count and phase are on separate cache lines
+class spin_barrier {
+  private:
+    alignas(64) std::atomic<int> count{0};
+    alignas(64) std::atomic<unsigned> phase{0};
+    int n = 1;
+
+  public:
+    void set_threads(int nthreads) {
+        n = nthreads;
+    }
+
+    void wait(int spin_limit) {
+        unsigned ph = phase.load(std::memory_order_acquire);
+        if (count.fetch_add(1, std::memory_order_acq_rel) == n - 1) {
+            // last one in: reset and release the others
+            count.store(0, std::memory_order_relaxed);
+            phase.fetch_add(1, std::memory_order_release);
+        } else {
+            int spins = 0;
+            while (phase.load(std::memory_order_acquire) == ph) {
+                if (++spins < spin_limit)
+                    cpu_relax();
+                else
+                    std::this_thread::yield();
+            }
+        }
+    }
+};
+
+struct pool_state {
+    int n_threads = 1;
+    std::vector<std::thread> workers;
+    std::vector<int> cpus; // cpus for pinning the workers, empty if not pinned
+    int spin_limit = spin_iterations;
+
+    // dispatch: a new loop is signalled by incrementing generation
+    alignas(64) std::atomic<unsigned> generation{0};
+    alignas(64) std::atomic<int> sleepers{0};
+    std::atomic<bool> busy{false};
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stop = false;
+
+    // the current loop
+    hila::thread_pool::body_function_t fn = nullptr;
+    void *body = nullptr;
+    int begin = 0, end = 0;
+
+    spin_barrier barrier;
+
+    // at exit() without finish() (e.g. hila::terminate) leave the workers running
+    ~pool_state() {
+        for (auto &w : workers)
+            if (w.joinable())
+                w.detach();
+    }
+};
+
+pool_state pool;
+
+thread_local bool thread_in_run = false;
+thread_local int serial_runs = 0; // > 0 while running a nested run() serially
+
+/// run the chunk of the current loop for thread t
+void run_chunk(int t) {
+    int len = pool.end - pool.begin;
+    int per = len / pool.n_threads;
+    int rem = len % pool.n_threads;
+    int b = pool.begin + t * per + std::min(t, rem);
+    int e = b + per + (t < rem ? 1 : 0);
+    if (e > b)
+        pool.fn(pool.body, b, e, t);
+}
+
+void worker_main(int t) {
+
+    if (pool.cpus.size() > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(pool.cpus[t], &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    thread_in_run = true;
+
+    unsigned seen = 0;
+    while (true) {
+        unsigned g;
+        int spins = 0;
+        while ((g = pool.generation.load(std::memory_order_acquire)) == seen) {
+            if (++spins < pool.spin_limit) {
+                cpu_relax();
+            } else {
+                // sleep until the next loop.  The generation is checked again
+                // under the lock, after sleepers has been incremented
+                std::unique_lock<std::mutex> lock(pool.mtx);
+                pool.sleepers++;
+                while (pool.generation.load() == seen)
+                    pool.cv.wait(lock);
+                pool.sleepers--;
+                spins = 0;
+            }
+        }
+        seen = g;
+        if (pool.stop)
+            return;
+
+        run_chunk(t);
+        pool.barrier.wait(pool.spin_limit);
+    }
+}
+
+/// wake up all workers for a new generation
+void signal_workers() {
+    pool.generation.fetch_add(1);
+    if (pool.sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(pool.mtx);
+        pool.cv.notify_all();
+    }
+}
+
+} // namespace
+
+
+void hila::thread_pool::initialize(int n) {
+
+    if (pool.workers.size() > 0)
+        return;
+
+    if (n <= 0) {
+#if defined(OPENMP)
+        n = omp_get_max_threads();
+#else
+        n = std::thread::hardware_concurrency();
+#endif
+    }
+    if (n < 1)
+        n = 1;
+
+    pool.n_threads = n;
+    pool.barrier.set_threads(n);
+    pool.stop = false;
+
+    // pin to the cpus of the affinity mask, if there are enough of them
+    cpu_set_t set;
+    pool.cpus.clear();
+    pool.spin_limit = spin_iterations;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        if (CPU_COUNT(&set) >= n) {
+            for (int c = 0; c < CPU_SETSIZE && (int)pool.cpus.size() < n; c++)
+                if (CPU_ISSET(c, &set))
+                    pool.cpus.push_back(c);
+        } else {
+            pool.spin_limit = spin_iterations_oversubscribed;
+        }
+    }
+
+    for (int t = 1; t < n; t++)
+        pool.workers.emplace_back(worker_main, t);
+
+    hila::out0 << "Using option THREAD_POOL - with " << n << " threads";
+    if (n > 1 && pool.cpus.size() > 0)
+        hila::out0 << ", workers pinned to cpus";
+    else if (pool.spin_limit == spin_iterations_oversubscribed)
+        hila::out0 << ", more threads than cpus";
+    hila::out0 << '\n';
+}
+
+void hila::thread_pool::finish() {
+    if (pool.workers.size() == 0)
+        return;
+
+    pool.stop = true;
+    signal_workers();
+    for (auto &w : pool.workers)
+        w.join();
+    pool.workers.clear();
+    pool.n_threads = 1;
+    pool.barrier.set_threads(1);
+}
+
+int hila::thread_pool::threads() {
+    return pool.n_threads;
+}
+
+bool hila::thread_pool::in_run() {
+    return thread_in_run;
+}
+
+void hila::thread_pool::barrier() {
+    if (thread_in_run && serial_runs == 0 && pool.n_threads > 1)
+        pool.barrier.wait(pool.spin_limit);
+}
+
+void hila::thread_pool::run_body(int begin, int end, body_function_t fn, void *body) {
+
+    bool serial = pool.n_threads == 1 || thread_in_run;
+#if defined(OPENMP)
+    serial = serial || omp_in_parallel();
+#endif
+    if (serial || pool.busy.exchange(true)) {
+        // nested or concurrent call - run the whole range here
+        serial_runs++;
+        fn(body, begin, end, 0);
+        serial_runs--;
+        return;
+    }
+
+    pool.fn = fn;
+    pool.body = body;
+    pool.begin = begin;
+    pool.end = end;
+
+    signal_workers();
+
+    thread_in_run = true;
+    run_chunk(0);
+    pool.barrier.wait(pool.spin_limit);
+    thread_in_run = false;
+
+    pool.busy.store(false);
+}
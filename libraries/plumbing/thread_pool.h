@@ -0,0 +1,115 @@
+/** @file thread_pool.h */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <vector>
+#include <type_traits>
+#include <memory>
+
+/// Persistent thread pool for site loops.  When compiled with make option THREAD_POOL=1
+/// (hilapp option -thread-pool, together with ARCH=openmp), hilapp generated site loops
+/// run on this pool instead of opening a new '#pragma omp parallel for' region for
+/// each loop.  The worker threads are started in hila::initialize() and stay alive until
+/// hila::finishrun().  Between loops the workers spin for a short while waiting for the
+/// next loop and then sleep, so that they do not slow down OpenMP regions of the library.
+///
+/// The workers are pinned to the cpus of the process affinity mask (as given by
+/// mpirun/srun), worker i to the i:th cpu of the mask, if the mask contains at least as
+/// many cpus as there are threads.  The calling thread is not pinned.
+///
+/// The number of threads is omp_get_max_threads() (i.e. OMP_NUM_THREADS) in OpenMP
+/// builds, otherwise std::thread::hardware_concurrency().
+///
+///   hila::thread_pool::run(begin, end, body)
+///        Calls body(chunk_begin, chunk_end, thread) on all threads of the pool, with
+///        consecutive chunks of [begin, end) of (almost) equal size.  The calling thread
+///        is thread 0.  Returns when all chunks are done.  If called from within run()
+///        or from an OpenMP parallel region, the calling thread does the whole range.
+///
+///   hila::thread_pool::barrier()
+///        Spin barrier of all threads of the pool, callable only within run().
+///
+///   hila::thread_pool::threads()     Number of threads, including the calling thread
+///   hila::thread_pool::in_run()      True if this thread is running a chunk of run()
+///
+/// hila::synchronize_threads() maps to barrier() within run(), elsewhere the pool threads
+/// are idle and there is nothing to synchronize.
+///
+/// Partial results of the threads (reductions) are collected to hila::thread_slots<T>,
+/// which are combined in the order of threads, so that the results do not depend on the
+/// timing of the threads.
+
+namespace hila {
+
+namespace thread_pool {
+
+/// start the pool with n threads, n <= 0 uses the default (see above)
+void initialize(int n = 0);
+
+/// stop and join the worker threads
+void finish();
+
+int threads();
+bool in_run();
+void barrier();
+
+/// type erased loop body
+using body_function_t = void (*)(void *body, int begin, int end, int thread);
+
+void run_body(int begin, int end, body_function_t fn, void *body);
+
+template <typename F>
+void call_body(void *body, int begin, int end, int thread) {
+    (*static_cast<F *>(body))(begin, end, thread);
+}
+
+template <typename F>
+inline void run(int begin, int end, F &&body) {
+    using body_t = std::remove_reference_t<F>;
+    run_body(begin, end, &call_body<body_t>,
+             const_cast<void *>(static_cast<const void *>(std::addressof(body))));
+}
+
+} // namespace thread_pool
+
+
+/// Per-thread partial results, each on its own cache line.  All slots are initialized
+/// to init, so that threads without a chunk do not change the combined result.
+template <typename T>
+class thread_slots {
+  private:
+    struct alignas(64) slot_t {
+        T v;
+    };
+    std::vector<slot_t> slots;
+
+  public:
+    template <typename S>
+    explicit thread_slots(const S &init) : slots(thread_pool::threads()) {
+        for (auto &s : slots)
+            s.v = init;
+    }
+
+    T &operator[](int thread) {
+        return slots[thread].v;
+    }
+
+    /// r += sum of slots, in thread order
+    template <typename R>
+    void add_to(R &r) const {
+        for (const auto &s : slots)
+            r += s.v;
+    }
+
+    /// r *= product of slots, in thread order
+    template <typename R>
+    void multiply_to(R &r) const {
+        for (const auto &s : slots)
+            r *= s.v;
+    }
+};
+
+} // namespace hila
+
+#endif
@@ -0,0 +1,523 @@
+#ifndef MEASUREMENT_LOG_H
+#define MEASUREMENT_LOG_H
+
+#include "hila.h"
+#include <cstring>
+#include <cmath>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+
+namespace hila {
+
+/// class hila::measurement_log writes rows of named, typed measurement columns.  Columns
+/// are scalars or fixed-width vectors of integers (stored as int64) or floating point
+/// numbers (stored as double).  Rows can be written
+///   - to a binary columnar file, which is appended to if it exists with the same columns.
+///     Rows are buffered into blocks, which are written and flushed by a background
+///     thread, so that the measurement loop does no formatting or file I/O.
+///   - as text lines "<prefix> v1 v2 ..." to hila::out0, as the MEAS lines of the
+///     applications.  A legend line "Legend: names" is printed before the first row.
+/// I/O is done on rank 0 only, and values are taken from rank 0, as with hila::out0.
+///
+///   hila::measurement_log mlog("MEAS");
+///   int c_traj = mlog.add_column<int>("trajectory");
+///   int c_plaq = mlog.add_column<double>("plaq");
+///   int c_poly = mlog.add_column<Complex<double>>("polyakov");   // 2 doubles
+///   int c_prof = mlog.add_column<double>("profile", lattice.size(e_z));
+///   mlog.open("measurements.hml");            // optional, binary output
+///   mlog.text_output(false);                  // optional, text is on by default
+///   for each trajectory:
+///       mlog.set(c_traj, trajectory);
+///       mlog.set(c_plaq, plaq);
+///       mlog.set("polyakov", poly);             // also by name
+///       mlog.set(c_prof, profile_vector);
+///       mlog.write_row();
+///       if (checkpointing) {
+///           mlog.checkpoint();                // rows are on disk, row count saved
+///           checkpoint(...);
+///       }
+///   mlog.close();                             // before hila::finishrun()
+///
+/// A run continued from a checkpoint opens the file with open(fname, true).  Rows written
+/// after the last mlog.checkpoint() are then dropped, so that they are not duplicated.
+///
+/// Values which are not set before write_row() are written as NaN (floating point) or 0.
+/// Vector-valued columns accept std::vector or hila types (Complex, Vector, Matrix, ...),
+/// whose numbers are stored in order.
+///
+/// File format, native byte order:
+///   header:  "HILAMLOG", uint32 version, uint32 number of columns, and for each column
+///            uint32 length of name, name, uint8 type (0 = int64, 1 = double), uint32 width
+///   blocks:  "BLCK", uint32 number of rows n, and for each column its n * width values
+/// A block which is not complete (interrupted run) is dropped when the file is appended to.
+/// checkpoint() writes the number of rows to "<file>.rows".
+/// libraries/tools/measurement_log_reader.py reads the files.
+
+class measurement_log {
+  public:
+    enum class column_type : uint8_t { int64 = 0, float64 = 1 };
+
+  private:
+    static constexpr uint32_t version = 1;
+
+    struct column {
+        std::string name;
+        column_type type;
+        int width;
+        std::vector<char> data; // values of the buffered rows
+        std::vector<char> row;  // values of the current row
+    };
+
+    struct block {
+        uint32_t rows;
+        std::vector<std::vector<char>> data;
+    };
+
+    std::string prefix;
+    std::vector<column> columns;
+    bool text = true;
+    bool printed_legend = false;
+    bool started = false;
+    int precision = 8;
+
+    // binary output, on rank 0
+    std::string filename;
+    std::FILE *fp = nullptr;
+    uint32_t buffered_rows = 0;
+    uint64_t file_rows = 0; // rows in the file or queued to the writer
+    int block_rows = 256;
+    double flush_interval = 30;
+    double last_flush = 0;
+
+    // background writer
+    std::thread writer;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::condition_variable cv_idle;
+    std::deque<block> queue;
+    bool stop_writer = false;
+    bool writing = false;
+
+  public:
+    measurement_log(const std::string &text_prefix = "MEAS") : prefix(text_prefix) {}
+
+    ~measurement_log() {
+        close();
+    }
+
+    measurement_log(const measurement_log &) = delete;
+    measurement_log &operator=(const measurement_log &) = delete;
+
+    /// Add column of type T, which can be an arithmetic type or a hila type; width is the
+    /// number of elements of type T.  Returns the index of the column.
+    template <typename T>
+    int add_column(const std::string &name, int width = 1) {
+        if (started)
+            hila::error("measurement_log: columns must be added before the first row");
+        if (width < 1)
+            hila::error("measurement_log: column " + name + " has width < 1");
+        for (auto &c : columns)
+            if (c.name == name)
+                hila::error("measurement_log: duplicate column name " + name);
+
+        using A = hila::arithmetic_type<T>;
+        static_assert(std::is_arithmetic<A>::value, "measurement_log: column type must be "
+                                                    "arithmetic");
+        column c;
+        c.name = name;
+        c.type = std::is_integral<A>::value ? column_type::int64 : column_type::float64;
+        c.width = width * (sizeof(T) / sizeof(A));
+        c.row.resize(c.width * 8);
+        columns.push_back(std::move(c));
+        clear_row(columns.back());
+        return columns.size() - 1;
+    }
+
+    /// Index of the column, -1 if it does not exist
+    int column_index(const std::string &name) const {
+        for (int i = 0; i < columns.size(); i++)
+            if (columns[i].name == name)
+                return i;
+        return -1;
+    }
+
+    /// Text output to hila::out0 on or off, default on
+    void text_output(bool on) {
+        text = on;
+    }
+
+    /// Precision of text output
+    void set_precision(int p) {
+        precision = p;
+    }
+
+    /// Number of rows in a block of the binary file
+    void set_block_rows(int n) {
+        block_rows = std::max(n, 1);
+    }
+
+    /// Buffered rows are written at least every 'seconds', at the next write_row()
+    void set_flush_interval(double seconds) {
+        flush_interval = seconds;
+    }
+
+    /// Open the binary file.  If the file exists, its columns must be the same and rows
+    /// are appended.  If from_checkpoint is true, rows after the last checkpoint() are
+    /// dropped first.
+    void open(const std::string &fname, bool from_checkpoint = false) {
+        started = true;
+        filename = fname;
+        if (hila::myrank() != 0)
+            return;
+
+        std::string header = make_header();
+        bool append = false;
+        file_rows = 0;
+        if (std::filesystem::exists(fname)) {
+            auto size = std::filesystem::file_size(fname);
+            if (size > 0) {
+                append = true;
+                auto end = check_existing_file(fname, header, file_rows);
+                if (end < size) {
+                    hila::out0 << "measurement_log: dropping incomplete block at the end of "
+                               << fname << '\n';
+                    std::filesystem::resize_file(fname, end);
+                }
+                if (from_checkpoint)
+                    truncate_to_checkpoint(header);
+            }
+        }
+
+        fp = std::fopen(fname.c_str(), "ab");
+        if (fp == nullptr)
+            hila::error("measurement_log: cannot open file " + fname);
+        if (!append) {
+            std::fwrite(header.data(), 1, header.size(), fp);
+            std::fflush(fp);
+        }
+
+        stop_writer = false;
+        last_flush = hila::gettime();
+        writer = std::thread(&measurement_log::write_blocks, this);
+    }
+
+    /// Set value of scalar or hila type in column col
+    template <typename T, std::enable_if_t<hila::is_arithmetic<hila::arithmetic_type<T>>::value,
+                                           int> = 0>
+    void set(int col, const T &val) {
+        constexpr int n = sizeof(T) / sizeof(hila::arithmetic_type<T>);
+        column &c = get_column(col, n);
+        for (int i = 0; i < n; i++)
+            store(c, i, hila::get_number_in_var(val, i));
+    }
+
+    /// Set values of vector-valued column col
+    template <typename T>
+    void set(int col, const std::vector<T> &v) {
+        constexpr int n = sizeof(T) / sizeof(hila::arithmetic_type<T>);
+        column &c = get_column(col, n * v.size());
+        for (int j = 0; j < v.size(); j++)
+            for (int i = 0; i < n; i++)
+                store(c, j * n + i, hila::get_number_in_var(v[j], i));
+    }
+
+    template <typename T>
+    void set(const std::string &name, const T &val) {
+        int col = column_index(name);
+        if (col < 0)
+            hila::error("measurement_log: no column " + name);
+        set(col, val);
+    }
+
+    /// Write the current row to outputs, and clear it
+    void write_row() {
+        started = true;
+
+        if (text && hila::myrank() == 0) {
+            if (!printed_legend) {
+                hila::out0 << "Legend:";
+                for (auto &c : columns) {
+                    if (c.width == 1)
+                        hila::out0 << ' ' << c.name;
+                    else
+                        hila::out0 << ' ' << c.name << '[' << c.width << ']';
+                }
+                hila::out0 << '\n';
+                printed_legend = true;
+            }
+            std::stringstream ss;
+            ss.precision(precision);
+            ss << prefix;
+            for (auto &c : columns)
+                for (int i = 0; i < c.width; i++) {
+                    if (c.type == column_type::int64)
+                        ss << ' ' << load<int64_t>(c, i);
+                    else
+                        ss << ' ' << load<double>(c, i);
+                }
+            hila::out0 << ss.str() << '\n';
+        }
+
+        if (fp != nullptr) {
+            for (auto &c : columns)
+                c.data.insert(c.data.end(), c.row.begin(), c.row.end());
+            buffered_rows++;
+            if (buffered_rows >= block_rows || hila::gettime() - last_flush >= flush_interval)
+                flush();
+        }
+
+        for (auto &c : columns)
+            clear_row(c);
+    }
+
+    /// Hand the buffered rows to the writer thread
+    void flush() {
+        if (fp == nullptr || buffered_rows == 0)
+            return;
+        block b;
+        b.rows = buffered_rows;
+        for (auto &c : columns) {
+            b.data.push_back(std::move(c.data));
+            c.data.clear();
+        }
+        file_rows += buffered_rows;
+        buffered_rows = 0;
+        last_flush = hila::gettime();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            queue.push_back(std::move(b));
+        }
+        cv.notify_one();
+    }
+
+    /// Write the buffered rows to the file, and wait until they are written and flushed
+    void sync() {
+        if (fp == nullptr)
+            return;
+        flush();
+        std::unique_lock<std::mutex> lock(mtx);
+        while (writing || !queue.empty())
+            cv_idle.wait(lock);
+    }
+
+    /// Number of rows written to the binary file, including buffered rows.  Valid on
+    /// rank 0
+    uint64_t rows() const {
+        return file_rows + buffered_rows;
+    }
+
+    /// Write the rows to the file, and save the row count for open(fname, true).  Call
+    /// before checkpointing the run.
+    void checkpoint() {
+        if (fp == nullptr)
+            return;
+        sync();
+        std::string tmpname = filename + ".rows.tmp";
+        std::ofstream out(tmpname, std::ios::trunc);
+        out << file_rows << '\n';
+        out.close();
+        if (!out)
+            hila::error("measurement_log: cannot write " + tmpname);
+        std::filesystem::rename(tmpname, filename + ".rows");
+    }
+
+    /// Write all buffered rows and close the binary file.  Call before hila::finishrun(),
+    /// which does not return.
+    void close() {
+        if (fp == nullptr)
+            return;
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stop_writer = true;
+        }
+        cv.notify_one();
+        writer.join();
+        std::fclose(fp);
+        fp = nullptr;
+    }
+
+  private:
+    column &get_column(int col, int n) {
+        if (col < 0 || col >= columns.size())
+            hila::error("measurement_log: invalid column index " + std::to_string(col));
+        column &c = columns[col];
+        if (n != c.width)
+            hila::error("measurement_log: column " + c.name + " has width " +
+                        std::to_string(c.width) + ", got " + std::to_string(n) + " values");
+        return c;
+    }
+
+    template <typename A>
+    void store(column &c, int i, A val) {
+        if (c.type == column_type::int64) {
+            int64_t v = val;
+            std::memcpy(c.row.data() + 8 * i, &v, 8);
+        } else {
+            double v = val;
+            std::memcpy(c.row.data() + 8 * i, &v, 8);
+        }
+    }
+
+    template <typename A>
+    A load(const column &c, int i) const {
+        A v;
+        std::memcpy(&v, c.row.data() + 8 * i, 8);
+        return v;
+    }
+
+    void clear_row(column &c) {
+        for (int i = 0; i < c.width; i++) {
+            if (c.type == column_type::int64)
+                store(c, i, (int64_t)0);
+            else
+                store(c, i, std::nan(""));
+        }
+    }
+
+    template <typename T>
+    static void append_raw(std::string &s, T v) {
+        s.append(reinterpret_cast<const char *>(&v), sizeof(T));
+    }
+
+    std::string make_header() const {
+        std::string h = "HILAMLOG";
+        append_raw(h, version);
+        append_raw(h, (uint32_t)columns.size());
+        for (auto &c : columns) {
+            append_raw(h, (uint32_t)c.name.size());
+            h += c.name;
+            append_raw(h, (uint8_t)c.type);
+            append_raw(h, (uint32_t)c.width);
+        }
+        return h;
+    }
+
+    // Check that the header of an existing file matches, and return the end of the
+    // last complete block.  n_rows is set to the number of rows in complete blocks
+    uintmax_t check_existing_file(const std::string &fname, const std::string &header,
+                                  uint64_t &n_rows) const {
+        std::ifstream in(fname, std::ios::binary);
+        std::string h(header.size(), '\0');
+        in.read(h.data(), h.size());
+        if (!in || h != header)
+            hila::error("measurement_log: existing file " + fname +
+                        " has different columns or is not a measurement log");
+
+        size_t row_bytes = 0;
+        for (auto &c : columns)
+            row_bytes += 8 * c.width;
+
+        uintmax_t size = std::filesystem::file_size(fname);
+        uintmax_t end = header.size();
+        n_rows = 0;
+        while (end + 8 <= size) {
+            char tag[4];
+            uint32_t rows;
+            in.seekg(end);
+            in.read(tag, 4);
+            in.read(reinterpret_cast<char *>(&rows), 4);
+            if (!in || std::memcmp(tag, "BLCK", 4) != 0)
+                break;
+            uintmax_t next = end + 8 + (uintmax_t)rows * row_bytes;
+            if (next > size)
+                break;
+            end = next;
+            n_rows += rows;
+        }
+        return end;
+    }
+
+    // Drop the rows after the count saved by checkpoint().  The file has complete
+    // blocks only.  A block which is cut is rewritten with the rows which are kept
+    void truncate_to_checkpoint(const std::string &header) {
+        std::ifstream rf(filename + ".rows");
+        uint64_t keep;
+        if (!(rf >> keep)) {
+            hila::out0 << "measurement_log: no row count for " << filename
+                       << ", keeping all rows\n";
+            return;
+        }
+        if (keep >= file_rows) {
+            if (keep > file_rows)
+                hila::out0 << "measurement_log: " << filename << " has " << file_rows
+                           << " rows, checkpoint has " << keep << '\n';
+            return;
+        }
+
+        size_t row_bytes = 0;
+        for (auto &c : columns)
+            row_bytes += 8 * c.width;
+
+        std::fstream f(filename, std::ios::in | std::ios::out | std::ios::binary);
+        uintmax_t pos = header.size();
+        uint64_t n = 0;
+        uint32_t rows = 0;
+        while (true) {
+            f.seekg(pos + 4);
+            f.read(reinterpret_cast<char *>(&rows), 4);
+            if (n + rows > keep)
+                break;
+            n += rows;
+            pos += 8 + (uintmax_t)rows * row_bytes;
+        }
+
+        // block at pos is cut to k rows
+        uint32_t k = keep - n;
+        uintmax_t end = pos;
+        if (k > 0) {
+            std::vector<char> data((size_t)rows * row_bytes);
+            f.read(data.data(), data.size());
+            f.seekp(pos + 4);
+            f.write(reinterpret_cast<const char *>(&k), 4);
+            size_t offset = 0;
+            for (auto &c : columns) {
+                f.write(data.data() + offset * rows, (size_t)k * 8 * c.width);
+                offset += 8 * c.width;
+            }
+            end = pos + 8 + (uintmax_t)k * row_bytes;
+        }
+        f.close();
+        if (!f)
+            hila::error("measurement_log: cannot truncate " + filename);
+        std::filesystem::resize_file(filename, end);
+
+        hila::out0 << "measurement_log: continuing from checkpoint, dropping "
+                   << file_rows - keep << " rows of " << filename << '\n';
+        file_rows = keep;
+    }
+
+    // the background writer thread
+    void write_blocks() {
+        while (true) {
+            block b;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                while (!stop_writer && queue.empty())
+                    cv.wait(lock);
+                if (queue.empty())
+                    return;
+                b = std::move(queue.front());
+                queue.pop_front();
+                writing = true;
+            }
+            std::fwrite("BLCK", 1, 4, fp);
+            std::fwrite(&b.rows, 4, 1, fp);
+            for (auto &d : b.data)
+                std::fwrite(d.data(), 1, d.size(), fp);
+            std::fflush(fp);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                writing = false;
+            }
+            cv_idle.notify_all();
+        }
+    }
+};
+
+} // namespace hila
+
+#endif
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+Reader for the binary measurement logs written by hila::measurement_log
+(libraries/tools/measurement_log.h).
+
+As a module:
+    from measurement_log_reader import read_measurement_log
+    cols = read_measurement_log("measurements.hml")
+    plaq = cols["plaq"]            # numpy array of shape (rows,) or (rows, width)
+
+As a command:
+    measurement_log_reader.py measurements.hml             print rows as text
+    measurement_log_reader.py measurements.hml -s          print the columns
+    measurement_log_reader.py measurements.hml -c plaq,polyakov
+
+Without numpy the columns are lists of rows.  An incomplete block at the end of the
+file (interrupted run) is ignored.
+"""
+
+import struct
+import sys
+import argparse
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+MAGIC = b"HILAMLOG"
+TYPES = {0: "q", 1: "d"}  # int64, double
+
+
+def read_schema(f):
+    """Read the header, returns list of (name, type code, width)"""
+    if f.read(8) != MAGIC:
+        raise ValueError("not a hila measurement log")
+    version, ncols = struct.unpack("=II", f.read(8))
+    if version != 1:
+        raise ValueError("unknown measurement log version %d" % version)
+    schema = []
+    for _ in range(ncols):
+        (nlen,) = struct.unpack("=I", f.read(4))
+        name = f.read(nlen).decode()
+        typ, width = struct.unpack("=BI", f.read(5))
+        schema.append((name, TYPES[typ], width))
+    return schema
+
+
+def read_measurement_log(filename):
+    """Read all complete blocks, returns dict column name -> values"""
+    with open(filename, "rb") as f:
+        schema = read_schema(f)
+        data = f.read()
+
+    row_bytes = 8 * sum(w for _, _, w in schema)
+    chunks = {name: [] for name, _, _ in schema}
+    pos = 0
+    while pos + 8 <= len(data) and data[pos:pos + 4] == b"BLCK":
+        (rows,) = struct.unpack_from("=I", data, pos + 4)
+        if pos + 8 + rows * row_bytes > len(data):
+            break
+        pos += 8
+        for name, typ, width in schema:
+            n = rows * width
+            chunks[name].append((data, pos, rows, typ, width))
+            pos += 8 * n
+
+    cols = {}
+    for name, typ, width in schema:
+        if np is not None:
+            parts = [np.frombuffer(d, dtype="=" + ("i8" if t == "q" else "f8"),
+                                   count=r * w, offset=p).reshape(r, w)
+                     for d, p, r, t, w in chunks[name]]
+            a = np.concatenate(parts) if parts else np.zeros((0, width))
+            cols[name] = a[:, 0] if width == 1 else a
+        else:
+            rows = []
+            for d, p, r, t, w in chunks[name]:
+                vals = struct.unpack_from("=%d%s" % (r * w, t), d, p)
+                rows += [vals[i * w] if w == 1 else list(vals[i * w:(i + 1) * w])
+                         for i in range(r)]
+            cols[name] = rows
+    return cols
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Print a hila binary measurement log")
+    ap.add_argument("file")
+    ap.add_argument("-s", "--schema", action="store_true", help="print the columns only")
+    ap.add_argument("-c", "--columns", help="comma separated list of columns to print")
+    args = ap.parse_args()
+
+    with open(args.file, "rb") as f:
+        schema = read_schema(f)
+    if args.schema:
+        for name, typ, width in schema:
+            print("%-24s %-6s %d" % (name, "int64" if typ == "q" else "double", width))
+        return
+
+    names = args.columns.split(",") if args.columns else [s[0] for s in schema]
+    cols = read_measurement_log(args.file)
+    for n in names:
+        if n not in cols:
+            sys.exit("no column " + n)
+
+    types = {name: typ for name, typ, _ in schema}
+    print("# " + " ".join(names))
+    nrows = len(cols[names[0]]) if names else 0
+    for i in range(nrows):
+        vals = []
+        for n in names:
+            v = cols[n][i]
+            for x in (v if hasattr(v, "__len__") else [v]):
+                vals.append(str(int(x)) if types[n] == "q" else repr(float(x)))
+        print(" ".join(vals))
+
+
+if __name__ == "__main__":
+    main()
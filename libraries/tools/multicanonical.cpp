@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <regex>
 #include <cmath>
+#include <random>
 #include "hila.h"
 #include "tools/multicanonical.h"
 
@@ -174,6 +175,16 @@ static int_vector g_N_OP_BinTotal(1,0);
 static int g_WeightIterationCount = 0;
 static bool g_WeightIterationFlag = true;
 
+// Incrementally tracked order parameter and the random number stream for
+// accept_reject_increment(), identical on all processes. See set_OP().
+static double g_OP = 0;
+static std::mt19937_64 g_ARRng;
+// Slope applied in parity sweeps, see weight_slope()
+static double g_Slope = 0;
+// When true the weight iteration runs on all processes with identical input,
+// instead of process 0 only, and needs no broadcasts
+static bool g_ReplicatedIteration = false;
+
 namespace hila
 {
 namespace muca
@@ -585,6 +596,156 @@ bool accept_reject(const double OP_old, const double OP_new)
     return update;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Copies the weight function and the iteration state from process 0
+///        to all processes.
+/// @details The weights are read and iterated on process 0 only. For the
+///          incremental methods below each process holds a copy, so that
+///          weight lookups and accept/reject decisions need no communication.
+///          The copies are kept identical by running the weight iteration of
+///          accept_reject_increment() on all processes, see
+///          g_ReplicatedIteration.
+////////////////////////////////////////////////////////////////////////////////
+static void replicate_weight_function()
+{
+    hila::broadcast(g_OPValues);
+    hila::broadcast(g_OPBinLimits);
+    hila::broadcast(g_WValues);
+    hila::broadcast(g_N_OP_Bin);
+    hila::broadcast(g_N_OP_BinTotal);
+    hila::broadcast(g_WeightIterationCount);
+    hila::broadcast(g_WeightIterationFlag);
+    hila::broadcast(g_WParam.DIP.C);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Average slope of the weight function, (W_last - W_first) /
+///        (OP_last - OP_first) over the bin centres.
+/// @details Does not depend on the order parameter, see weight_slope().
+///
+/// @return slope of the straight line through the end points of the weights
+////////////////////////////////////////////////////////////////////////////////
+static double weight_function_mean_slope()
+{
+    if (g_OPValues.size() < 2)
+    {
+        return 0;
+    }
+    return (g_WValues.back() - g_WValues.front()) /
+           (g_OPValues.back() - g_OPValues.front());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Starts incremental tracking of the order parameter.
+/// @details Instead of measuring the order parameter of each proposed
+///          configuration, the update loops accumulate the per-site changes
+///          of the order parameter in the same site loop which does the
+///          update, e.g. in a Reduction<double>, and pass the total to
+///          accept_reject_increment(). This avoids a separate measurement
+///          pass over the lattice for each accept/reject step.
+///
+///          Must be called by all processes with the same value, after
+///          initialise() and whenever the configuration is changed by other
+///          means, or the weights by accept_reject() with iteration. The
+///          weight function and iteration state are copied to all processes,
+///          the slope returned by weight_slope() is fixed, and the random
+///          number stream of the accept/reject decisions is seeded
+///          identically on all processes. These are the only collective
+///          operations of the incremental methods.
+///
+/// @param OP   current value of the order parameter
+////////////////////////////////////////////////////////////////////////////////
+void set_OP(double OP)
+{
+    replicate_weight_function();
+    double seed = hila::broadcast(hila::random());
+    g_ARRng.seed(static_cast<uint64_t>(seed * 9007199254740992.0));
+    g_OP = OP;
+    g_Slope = weight_function_mean_slope();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Returns the incrementally tracked order parameter.
+////////////////////////////////////////////////////////////////////////////////
+double get_OP()
+{
+    return g_OP;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Weight at the tracked order parameter, for reweighting measurements.
+/// @details Valid on all processes after set_OP(), without communication.
+////////////////////////////////////////////////////////////////////////////////
+double current_weight()
+{
+    return weight_function(g_OP);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Linear part dW/dOP of the weight function, for parity sweeps.
+/// @details Used for multicanonical acceptance within a parity sweep: with
+///          a = weight_slope() the site update is accepted with the
+///          probability exp(-dS_x - a dOP_x), where dOP_x is the change of the
+///          order parameter by the update of site x. Sites of one parity are
+///          independent, so this can be done in the usual update site loop.
+///          The remaining non-linear part of the weight is then applied once
+///          per sweep by accept_reject_increment(dOP, a).
+///
+///          The sweep with the final accept/reject satisfies detailed balance
+///          only if the reverse sweep uses the same a. Therefore a does not
+///          depend on the order parameter: it is the average slope of the
+///          weight function, fixed in set_OP().
+///
+/// @return slope applied in the site updates, same on all processes
+////////////////////////////////////////////////////////////////////////////////
+double weight_slope()
+{
+    return g_Slope;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Accepts/rejects a multicanonical update given the order parameter
+///        change.
+/// @details The update is accepted with the logarithmic probability
+///          log(P) = - (W(OP + dOP) - W(OP)) + slope_used * dOP,
+///          where OP is the tracked order parameter and slope_used is the
+///          slope already applied in the site-local acceptance (see
+///          weight_slope()), or 0 for plain multicanonical accept/reject.
+///          The tracked order parameter is updated if accepted.
+///
+///          All processes compute the same decision from the same input, so
+///          no broadcast is needed. dOP should come from a reduction which
+///          is summed to all processes (the default for Reduction).
+///          When weight iteration is on, the weights are iterated on all
+///          processes with the same input, which keeps the copies identical
+///          without communication.
+///
+/// @param  dOP          order parameter change of the proposed update
+/// @param  slope_used   slope of the weight applied in the site updates
+/// @return Boolean indicating whether the update was accepted (true) or
+///         rejected (false).
+////////////////////////////////////////////////////////////////////////////////
+bool accept_reject_increment(const double dOP, const double slope_used)
+{
+    double OP_new = g_OP + dOP;
+    double log_P = - (weight_function(OP_new) - weight_function(g_OP))
+                   + slope_used * dOP;
+
+    // Uniform random number in [0,1), equal on all processes
+    double rval = (g_ARRng() >> 11) * (1.0 / 9007199254740992.0);
+    bool update = ::log(rval) < log_P;
+    if (update) g_OP = OP_new;
+
+    if (g_WParam.AR_iteration)
+    {
+        g_ReplicatedIteration = true;
+        g_WeightIterationFlag = iterate_weights(g_OP);
+        g_ReplicatedIteration = false;
+    }
+
+    return update;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Finds the index of the correc order parameter bin.
 /// @details Using the bin limit vector the correct order parameter bin is
@@ -954,7 +1115,7 @@ static void initialise_weight_vectors()
 static bool iterate_weight_function_direct(double OP)
 {
     bool continue_iteration;
-    if (hila::myrank() == 0)
+    if (hila::myrank() == 0 || g_ReplicatedIteration)
     {
         int samples = g_WParam.DIP.sample_size;
         int N       = g_WValues.size();
@@ -970,7 +1131,8 @@ static bool iterate_weight_function_direct(double OP)
                 g_N_OP_BinTotal[m] += g_N_OP_Bin[m];
             }
 
-            if (g_WParam.visuals) print_iteration_histogram();
+            if (g_WParam.visuals && hila::myrank() == 0)
+                print_iteration_histogram();
 
             double base = *std::min_element(g_WValues.begin(), g_WValues.end());
             for (int m = 0; m < N; ++m)
@@ -1005,7 +1167,7 @@ static bool iterate_weight_function_direct(double OP)
             continue_iteration = false;
         }
     }
-    hila::broadcast(continue_iteration);
+    if (!g_ReplicatedIteration) hila::broadcast(continue_iteration);
     return continue_iteration;
 }
 
@@ -1024,7 +1186,7 @@ static bool iterate_weight_function_direct(double OP)
 static bool iterate_weight_function_direct_single(double OP)
 {
     int continue_iteration;
-    if (hila::myrank() == 0)
+    if (hila::myrank() == 0 || g_ReplicatedIteration)
     {
         int samples = g_WParam.DIP.sample_size;
         int N       = g_WValues.size();
@@ -1051,7 +1213,8 @@ static bool iterate_weight_function_direct_single(double OP)
         }
 
         // Visuals
-        if (g_WParam.visuals) print_iteration_histogram();
+        if (g_WParam.visuals && hila::myrank() == 0)
+            print_iteration_histogram();
 
         // If condition satisfied, zero the totals and decrease C
         if (finish_check(g_N_OP_BinTotal))
@@ -1078,7 +1241,7 @@ static bool iterate_weight_function_direct_single(double OP)
         hila::out0 << "Update size C = " << g_WParam.DIP.C << "\n\n";
         }
     }
-    hila::broadcast(continue_iteration);
+    if (!g_ReplicatedIteration) hila::broadcast(continue_iteration);
     return continue_iteration;
 }
 
@@ -1174,7 +1337,7 @@ static void setup_iteration()
 ////////////////////////////////////////////////////////////////////////////////
 void set_continuous_iteration(bool YN)
 {
-    if (hila::myrank() == 0) g_WParam.AR_iteration = YN;
+    g_WParam.AR_iteration = YN;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -47,6 +47,15 @@ double weight(double OP);
 // Accept/reject determination for pairs of order parameter values
 bool accept_reject(const double OP_old, const double OP_new);
 
+// Incremental order parameter tracking: the update loops accumulate the
+// change of the order parameter, and the weight lookups and accept/reject
+// decisions are done on all processes without communication.
+void set_OP(double OP);
+double get_OP();
+double current_weight();
+double weight_slope();
+bool accept_reject_increment(const double dOP, const double slope_used = 0);
+
 // Set the direct iteration finish condition
 void set_direct_iteration_FC(bool (* fc_pointer)(std::vector<int> &n));
 
@@ -70,6 +79,10 @@ static void bin_OP_value(double OP);
 
 static int find_OP_bin_index(double OP);
 
+static void replicate_weight_function();
+
+static double weight_function_mean_slope();
+
 static bool all_visited(std::vector<int> &n);
 static bool first_last_visited(std::vector<int> &n);
 
@@ -0,0 +1,160 @@
+#ifndef UNEQUAL_TIME_CORRELATOR_H
+#define UNEQUAL_TIME_CORRELATOR_H
+
+#include "hila.h"
+
+namespace hila {
+
+/// class hila::unequal_time_correlator accumulates momentum-resolved unequal-time
+/// correlators of a field during a time evolution, without storing snapshots:
+///   C(k, tau) = < Re f(k, t)^* . f(k, t + tau) > / V
+/// averaged over reference times t and over k-vectors within a bin of |k| (see
+/// hila::k_binning).  Here f(k) = sum_x exp(-ik.x) f(x), and . sums over all components
+/// of f.  Time is measured in steps, i.e. calls to add().
+///
+/// Every ref_interval steps the FFT of the field is stored as a new reference, and at each
+/// step the current field is correlated with all references at most max_lag steps old.
+/// Thus at most max_lag / ref_interval + 1 reference fields are kept in memory.
+///
+/// Real components of f are packed pairwise into complex numbers before the FFT,
+/// as in k_binning::spectraldensity().  The cross terms this generates are odd in k and
+/// cancel in the bins, because k and -k are always in the same bin.
+///
+///   hila::unequal_time_correlator<T> corr(max_lag, ref_interval);
+///   for each trajectory:
+///       corr.start();                   // drop the references of previous trajectory
+///       for each step:
+///           ... evolve f ...
+///           corr.add(f);
+///   auto c = corr.correlator(lag);      // vector over k-bins, valid on rank 0
+///
+/// methods:
+///   hila::k_binning & binning()         binning of k, can be modified before first add()
+///   void start()                        start a new evolution, drops references
+///   void add(const Field<T> &f)         add field at the next step
+///   int max_lag()                       max lag, in steps
+///   std::vector<double> correlator(int lag)   C(k, lag) for each k-bin
+///   long samples(int lag)               number of reference times averaged at lag
+
+template <typename T>
+class unequal_time_correlator {
+  private:
+    using cmplx_t = Complex<hila::arithmetic_type<T>>;
+    static constexpr int nc = (sizeof(T) + sizeof(cmplx_t) - 1) / sizeof(cmplx_t);
+    using ctype = Vector<nc, cmplx_t>;
+
+    k_binning kb;
+    int lag_max, ref_interval;
+    int step;
+
+    // FFT modes of reference fields, used as a ring buffer
+    std::vector<Field<ctype>> ref;
+    std::vector<int> ref_step;
+
+    // accumulated correlators [lag][bin] and numbers of samples [lag]
+    std::vector<std::vector<double>> corr;
+    std::vector<long> n_samples;
+
+  public:
+    unequal_time_correlator(int max_lag, int interval = 1) {
+        assert(max_lag >= 0 && interval > 0);
+        lag_max = max_lag;
+        ref_interval = interval;
+        ref.resize(max_lag / interval + 1);
+        ref_step.assign(ref.size(), -1);
+        corr.resize(max_lag + 1);
+        n_samples.assign(max_lag + 1, 0);
+        step = 0;
+    }
+
+    k_binning &binning() {
+        return kb;
+    }
+
+    int max_lag() const {
+        return lag_max;
+    }
+
+    /// Start a new time evolution: references from the previous evolution are dropped, the
+    /// accumulated correlators are kept
+    void start() {
+        step = 0;
+        ref_step.assign(ref.size(), -1);
+    }
+
+    /// Add the field at the next step of the evolution
+    void add(const Field<T> &f) {
+
+        static hila::timer corr_timer("Unequal-time correlators");
+        corr_timer.start();
+
+        Field<ctype> fk;
+        if constexpr (sizeof(T) == sizeof(ctype)) {
+            // layouts are compatible, see k_binning::spectraldensity()
+            FFT_field(*reinterpret_cast<const Field<ctype> *>(&f), fk);
+        } else {
+            Field<ctype> cfield;
+            onsites(ALL) {
+                cfield[X] = 0;
+                for (int i = 0; i < sizeof(T) / sizeof(hila::arithmetic_type<T>); i++) {
+                    auto a = hila::get_number_in_var(f[X], i);
+                    hila::set_number_in_var(cfield[X], i, a);
+                }
+            }
+            FFT_field(cfield, fk);
+        }
+
+        if (step % ref_interval == 0) {
+            // the slot holds a reference older than max_lag, if any
+            int slot = (step / ref_interval) % ref.size();
+            ref[slot] = fk;
+            ref_step[slot] = step;
+        }
+
+        for (int r = 0; r < ref.size(); r++) {
+            int lag = step - ref_step[r];
+            if (ref_step[r] < 0 || lag > lag_max)
+                continue;
+
+            const Field<ctype> &rf = ref[r];
+            Field<double> prod;
+            onsites(ALL) {
+                prod[X] = real(rf[X].dot(fk[X]));
+            }
+
+            auto b = kb.bin_k_field(prod);
+            if (corr[lag].size() != b.size())
+                corr[lag].assign(b.size(), 0.0);
+            for (int i = 0; i < b.size(); i++)
+                corr[lag][i] += b[i];
+            n_samples[lag]++;
+        }
+
+        step++;
+
+        corr_timer.stop();
+    }
+
+    /// Correlator at lag for each k-bin, normalized by volume and the number of k-vectors
+    /// in the bin.  Valid on rank 0.  Must be called on all ranks, because
+    /// k_binning::count() may need to compute the bin info.
+    std::vector<double> correlator(int lag) {
+        assert(lag >= 0 && lag <= lag_max);
+        std::vector<double> res(kb.bins(), 0.0);
+        for (int i = 0; i < kb.bins(); i++) {
+            long n = kb.count(i);
+            if (n > 0 && n_samples[lag] > 0 && i < corr[lag].size())
+                res[i] = corr[lag][i] / ((double)n_samples[lag] * lattice.volume() * n);
+        }
+        return res;
+    }
+
+    /// Number of reference times averaged at lag
+    long samples(int lag) const {
+        return n_samples[lag];
+    }
+};
+
+} // namespace hila
+
+#endif
@@ -0,0 +1,90 @@
+#include "hila.h"
+#include "catch.hpp"
+#include "catch_main.hpp"
+
+class SiteRegionTest {
+
+  public:
+    // number of region sites over all ranks
+    long global_size(const SiteRegion &r) {
+        long n = r.size();
+        hila::reduce_node_sum(&n, 1, true);
+        return n;
+    }
+};
+
+TEST_CASE_METHOD(SiteRegionTest, "SiteRegion site lists", "[SiteRegion]") {
+    SECTION("Plane") {
+        SiteRegion r = SiteRegion::plane(e_y, 3);
+        long wrong = 0;
+        for (size_t i = 0; i < r.size(); i++)
+            if (lattice.coordinates(r.site_index(i))[e_y] != 3)
+                wrong++;
+        hila::reduce_node_sum(&wrong, 1, true);
+        REQUIRE(wrong == 0);
+        REQUIRE(global_size(r) == lattice.volume() / lattice_size);
+        REQUIRE(r.parity() == ALL);
+    }
+    SECTION("Box") {
+        CoordinateVector cmin = {1, 2, 3}, cmax = {4, 2, 70};
+        SiteRegion r = SiteRegion::box(cmin, cmax);
+        REQUIRE(global_size(r) == 4 * 1 * 68);
+        REQUIRE(r.parity() == ALL);
+        REQUIRE(SiteRegion::box(cmin, cmin).parity() == EVEN);
+    }
+    SECTION("Coordinate list") {
+        std::vector<CoordinateVector> clist = {{0, 0, 0}, {1, 1, 0}, {1, 1, 0}, {5, 0, 65}};
+        SiteRegion r(clist);
+        REQUIRE(global_size(r) == 3);
+        REQUIRE(r.parity() == EVEN);
+        clist.push_back({0, 0, 1});
+        REQUIRE(SiteRegion(clist).parity() == ALL);
+    }
+}
+
+TEST_CASE_METHOD(SiteRegionTest, "SiteRegion loops", "[SiteRegion]") {
+    Field<double> f, g;
+    onsites(ALL) f[X] = X.coordinate(e_x) + lattice_size * X.coordinate(e_z);
+    g = -1;
+    SiteRegion r = SiteRegion::plane(e_z, lattice_size - 1);
+
+    SECTION("Loop visits only the region") {
+        double s = 0;
+        onsites(r) {
+            s += 1;
+            g[X] = f[X];
+        }
+        REQUIRE(s == lattice.volume() / lattice_size);
+
+        long wrong = 0;
+        onsites(ALL) {
+            if (X.coordinate(e_z) == lattice_size - 1) {
+                if (g[X] != f[X])
+                    wrong += 1;
+            } else if (g[X] != -1) {
+                wrong += 1;
+            }
+        }
+        REQUIRE(wrong == 0);
+    }
+    SECTION("Neighbour access across the region boundary") {
+        onsites(r) g[X] = f[X + e_z] + f[X - e_x];
+
+        long wrong = 0;
+        onsites(ALL) {
+            if (X.coordinate(e_z) == lattice_size - 1 && g[X] != f[X + e_z] + f[X - e_x])
+                wrong += 1;
+        }
+        REQUIRE(wrong == 0);
+    }
+    SECTION("Region write invalidates gathers") {
+        onsites(ALL) g[X] = f[X + e_z];
+        onsites(SiteRegion::plane(e_z, 0)) f[X] = 0;
+        long wrong = 0;
+        onsites(ALL) {
+            if (X.coordinate(e_z) == lattice_size - 1 && f[X + e_z] != 0)
+                wrong += 1;
+        }
+        REQUIRE(wrong == 0);
+    }
+}